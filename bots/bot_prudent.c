@@ -0,0 +1,63 @@
+// Robot prudent : va tout droit tant que c'est possible, sinon tourne
+// du côté qui laisse le plus de cases libres autour de la tête
+#include "snakeBot.h"
+
+// Vrai si la case (x,y) est dans la liste de cases t de longueur len
+static bool dans_serpent(const BotCase t[], size_t len, int x, int y) {
+	for (size_t i = 0; i < len; i++)
+		if (t[i].x == x && t[i].y == y)
+			return true;
+	return false;
+}
+
+// Vrai si le serpent peut aller sur la case (x,y) sans mourir
+static bool case_libre(const BotVue *vue, int x, int y) {
+	if (x < 0 || x >= vue->cols || y < 0 || y >= vue->lines)
+		return false;
+	if (vue->obstacle[y * vue->cols + x])
+		return false;
+	return !dans_serpent(vue->moi, vue->len_moi, x, y)
+		&& !dans_serpent(vue->adversaire, vue->len_adversaire, x, y);
+}
+
+// Case atteinte en avançant d'une case dans la direction d
+static BotCase avance(BotCase p, BotDirection d) {
+	switch (d) {
+		case BOT_HAUT: p.y--; break;
+		case BOT_BAS: p.y++; break;
+		case BOT_VERS_GAUCHE: p.x--; break;
+		case BOT_VERS_DROITE: p.x++; break;
+	}
+	return p;
+}
+
+// Direction après avoir tourné
+static BotDirection tourne(BotDirection d, BotTourne t) {
+	static const BotDirection gauche[4] = {BOT_VERS_GAUCHE, BOT_VERS_DROITE, BOT_BAS, BOT_HAUT};
+	static const BotDirection droite[4] = {BOT_VERS_DROITE, BOT_VERS_GAUCHE, BOT_HAUT, BOT_BAS};
+	switch (t) {
+		case BOT_GAUCHE: return gauche[d];
+		case BOT_DROITE: return droite[d];
+		default: return d;
+	}
+}
+
+BotTourne snake_bot_tourne(const BotVue *vue) {
+	const BotTourne choix[3] = {BOT_TOUT_DROIT, BOT_GAUCHE, BOT_DROITE};
+	BotTourne meilleur = BOT_TOUT_DROIT;
+	int meilleur_score = -1;
+	for (int c = 0; c < 3; c++) {
+		BotCase p = avance(vue->moi[0], tourne(vue->direction, choix[c]));
+		if (!case_libre(vue, p.x, p.y))
+			continue;
+		// Score : nombre de cases libres autour de la case d'arrivée
+		int score = case_libre(vue, p.x+1, p.y) + case_libre(vue, p.x-1, p.y)
+			+ case_libre(vue, p.x, p.y+1) + case_libre(vue, p.x, p.y-1);
+		// Tout droit est préféré à égalité
+		if (score > meilleur_score) {
+			meilleur = choix[c];
+			meilleur_score = score;
+		}
+	}
+	return meilleur;
+}
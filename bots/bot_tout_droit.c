@@ -0,0 +1,8 @@
+// Robot le plus simple : va toujours tout droit
+// Sert de modèle pour écrire un robot et d'adversaire de référence
+#include "snakeBot.h"
+
+BotTourne snake_bot_tourne(const BotVue *vue) {
+	(void)vue;
+	return BOT_TOUT_DROIT;
+}
@@ -8,9 +8,8 @@
 // Liste des couleurs de base : fond et caracteres de couleur identique.
 typedef enum {none,black,red,green,yellow,blue,magenta,cyan,white} Color;
 
-// Initialise le mode curses
-void startCurses() {
-    initscr(); // Debute le mode curses
+// Configure le terminal courant : couleurs, curseur et clavier
+void configureCurses() {
     // Verifie que le terminal accepte la couleur
     if(has_colors() == false)
     {	endwin();
@@ -39,6 +38,30 @@ void startCurses() {
     bkgd(' '| COLOR_PAIR(black));
 }
 
+// Initialise le mode curses
+void startCurses() {
+    initscr(); // Debute le mode curses
+    configureCurses();
+}
+
+// Initialise le mode curses sans écran : l'affichage part dans /dev/null
+// Sert à jouer des parties sans terminal sur un jeux de cols x lines
+void startCursesSansEcran(int cols, int lines) {
+    FILE *sortie = fopen("/dev/null", "w");
+    FILE *entree = fopen("/dev/null", "r");
+    char taille[16];
+    // La taille du jeux est lue dans l'environnement par newterm
+    snprintf(taille, sizeof(taille), "%d", cols);
+    setenv("COLUMNS", taille, 1);
+    snprintf(taille, sizeof(taille), "%d", lines);
+    setenv("LINES", taille, 1);
+    if (sortie == NULL || entree == NULL || newterm("xterm", sortie, entree) == NULL) {
+        printf("Impossible de démarrer curses sans écran ...\n");
+        exit(1);
+    }
+    configureCurses();
+}
+
 // Termine le mode curses
 void stopCurses() {
     endwin();
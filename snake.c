@@ -1,10 +1,22 @@
 
+// Pour clock_gettime et setenv avec -std=c99
+#define _POSIX_C_SOURCE 200809L
 #include <stdbool.h>
 #include <assert.h>
 #include "miniCurses.h"
+#include "snakeBot.h"
 #include <math.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
+#include <stdint.h>
+#include <limits.h>
+#include <inttypes.h>
+#include <dlfcn.h>
+#include <pthread.h>
+#include <errno.h>
+#include <dirent.h>
+#include <sys/stat.h>
 
 //////////////////////////////////////////////////////////////////////////
 // Partie définition et gestion des pixels seuls
@@ -24,9 +36,20 @@ Pixel pix_new(int x, int y) {
 	return p;
 }
 
+// Taille de l'aire de jeux, fixée par aire_init au démarrage de curses
+// Agrandir le terminal pendant la partie ne change pas l'aire de jeux
+int aire_cols = 0;
+int aire_lines = 0;
+
+// Fixe l'aire de jeux à la taille courante du terminal (COLS x LINES)
+void aire_init() {
+	aire_cols = COLS;
+	aire_lines = LINES;
+}
+
 // Vrai si p est dans l'espace de jeux
 bool is_pix_in_game(Pixel p) {
-	return p.x >= 0 && p.x < COLS && p.y >= 0 && p.y < LINES;
+	return p.x >= 0 && p.x < aire_cols && p.y >= 0 && p.y < aire_lines;
 }
 
 // Definition d'un pixel qui sert de valeur sentinelle
@@ -124,6 +147,22 @@ void pix_push(Pixel t[],size_t size, Pixel p) {
 	t[0] = p;
 }
 
+// Enlève le pixel du début de la chaîne de pixels de t
+// La longueur est réduite de 1.
+// t: un tableau de pixel terminé par la sentinelle
+// return: le pixel enlevé du début de la chaine
+Pixel pix_pop(Pixel t[]) {
+	// Calcule la longueur de la chaîne
+	size_t len = pix_len(t);
+	// Vérifie qu'il est possible d'enlever un élément
+	assert(len >= 1);
+	Pixel p_return = t[0];
+	// Décale tous les elements d'une case vers la gauche, sentinelle comprise
+	for (size_t i = 0; i < len; i++)
+		t[i] = t[i+1];
+	return p_return;
+}
+
 // Valeur qui indique une valeur non trouvée
 const size_t NOT_FOUND = (size_t)-1;
 
@@ -134,10 +173,10 @@ const size_t NOT_FOUND = (size_t)-1;
 size_t pix_find(Pixel t[],Pixel p) {
 	size_t len = pix_len(t);
 	size_t i = 0;
-	while ((i <= len)&&!(pix_equal(t[i],p)))
+	while ((i < len)&&!(pix_equal(t[i],p)))
 		i++;
 	// t[i]==p (pixel trouvé) ou i == len (arrivé à la fin du tableau)
-	if(!pix_equal(t[i],p))
+	if(i == len)
 		return NOT_FOUND;
 	return i;
 }
@@ -150,9 +189,8 @@ size_t pix_find(Pixel t[],Pixel p) {
 // obst : le tableau des obstacles
 // size : la taille du tableau obst
 // len : le nombre d'obstacles à créer dans obst (lenght)
+// La fonction hasard (random) doit déjà être initialisée avec srand
 void obst_init(Pixel obst[], size_t size, size_t len) {
-	// Initialise la fonction hasard (random)
-	srand (time(NULL));
 	// on ne peut pas créer plus d'obstacles que la taille du tableau
 	assert(len < size);
 	// clear le tableau obstacle
@@ -161,7 +199,7 @@ void obst_init(Pixel obst[], size_t size, size_t len) {
 	Pixel p_rand;
 	// Génère un pixel de position aléatoire et le stock s'il n'existe pas déjà dans le tableau
 	while (i < len) {
-		p_rand = pix_new(rand()%(COLS), rand()%(LINES));
+		p_rand = pix_new(rand()%(aire_cols), rand()%(aire_lines));
 		if ((pix_find(obst, p_rand) == NOT_FOUND)){
 			pix_push_back(obst, size, p_rand);
 			i++;
@@ -175,6 +213,280 @@ void obst_draw(Pixel obst[]) {
 		drawChar(obst[i].x, obst[i].y,'#',red);
 }
 
+// Index des obstacles pour tester une collision en O(1)
+// Une case par pixel du jeux, vraie si un obstacle s'y trouve
+typedef struct {
+	int cols;        // largeur du jeux à l'initialisation
+	int lines;       // hauteur du jeux à l'initialisation
+	bool *occupe;    // cols * lines cases
+} GrilleObst;
+
+// Construit l'index des obstacles de obst pour la taille courante du jeux
+void grille_init(GrilleObst *grille, Pixel obst[]) {
+	grille->cols = aire_cols;
+	grille->lines = aire_lines;
+	grille->occupe = calloc((size_t)aire_cols * aire_lines, sizeof(bool));
+	if (grille->occupe == NULL) {
+		printf("Erreur : mémoire insuffisante pour l'index des obstacles\n");
+		exit(1);
+	}
+	for (size_t i = 0; ! is_pix_end(obst[i]); i++)
+		grille->occupe[obst[i].y * grille->cols + obst[i].x] = true;
+}
+
+// Libère la mémoire de l'index
+void grille_free(GrilleObst *grille) {
+	free(grille->occupe);
+	grille->occupe = NULL;
+}
+
+// Vrai si un obstacle est sur la case p
+bool grille_contient(const GrilleObst *grille, Pixel p) {
+	if (p.x < 0 || p.x >= grille->cols || p.y < 0 || p.y >= grille->lines)
+		return false;
+	return grille->occupe[p.y * grille->cols + p.x];
+}
+
+// Met ou enlève un obstacle de la case p
+void grille_set(GrilleObst *grille, Pixel p, bool occupe) {
+	assert(p.x >= 0 && p.x < grille->cols && p.y >= 0 && p.y < grille->lines);
+	grille->occupe[p.y * grille->cols + p.x] = occupe;
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+// Partie hachage de Zobrist de l'état du jeux
+//////////////////////////////////////////////////////////////////////////
+
+// L'empreinte de l'état est le XOR d'une clé aléatoire par élément présent :
+// chaque obstacle, chaque case de chaque serpent, la direction de chaque
+// serpent et la valeur de growTime. Ajouter ou enlever un élément revient à
+// faire un XOR avec sa clé, donc la mise à jour est en O(1) à chaque mouvement.
+
+// Nombre de directions possibles d'un serpent
+#define NB_DIRECTIONS 4
+
+// Graine fixe : les clés doivent être identiques d'un processus à l'autre
+// pour pouvoir comparer les empreintes de deux exécutions
+#define ZOBRIST_GRAINE 0x5eed5eed5eed5eedULL
+
+// Plan de hachage : chaque case a une clé par type d'occupant
+typedef enum {PLAN_OBST, PLAN_SNAKE1, PLAN_SNAKE2, NB_PLANS} PlanZobrist;
+
+// Les clés et l'empreinte courante de l'état du jeux
+typedef struct {
+	int cols;                // largeur du jeux à l'initialisation
+	int lines;               // hauteur du jeux à l'initialisation
+	uint64_t *cle_case;      // NB_PLANS * cols * lines clés
+	uint64_t cle_dir[2][NB_DIRECTIONS]; // clés des directions des 2 serpents
+	uint64_t *cle_grow;      // une clé par valeur de growTime (0..growTimeMax)
+	int growTimeMax;
+	int dir[2];              // directions prises en compte dans l'empreinte
+	int growTime;            // growTime pris en compte dans l'empreinte
+	uint64_t hash;           // empreinte courante
+} Zobrist;
+
+// Générateur pseudo-aléatoire splitmix64
+// etat: l'état du générateur, modifié à chaque appel
+uint64_t zob_rand(uint64_t *etat) {
+	uint64_t z = (*etat += 0x9e3779b97f4a7c15ULL);
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+	return z ^ (z >> 31);
+}
+
+// Initialise les clés pour la taille courante du jeux (aire_cols x aire_lines)
+// L'empreinte vaut 0 : il faut appeler zob_reset avant de l'utiliser
+void zob_init(Zobrist *zob, int growTimeMax) {
+	assert(growTimeMax >= 0);
+	zob->cols = aire_cols;
+	zob->lines = aire_lines;
+	zob->growTimeMax = growTimeMax;
+	size_t nb_cles = (size_t)NB_PLANS * aire_cols * aire_lines;
+	zob->cle_case = malloc(nb_cles * sizeof(uint64_t));
+	zob->cle_grow = malloc((growTimeMax + 1) * sizeof(uint64_t));
+	if (zob->cle_case == NULL || zob->cle_grow == NULL) {
+		printf("Erreur : mémoire insuffisante pour le hachage de Zobrist\n");
+		exit(1);
+	}
+	uint64_t etat = ZOBRIST_GRAINE;
+	for (size_t i = 0; i < nb_cles; i++)
+		zob->cle_case[i] = zob_rand(&etat);
+	for (int j = 0; j < 2; j++)
+		for (int d = 0; d < NB_DIRECTIONS; d++)
+			zob->cle_dir[j][d] = zob_rand(&etat);
+	for (int g = 0; g <= growTimeMax; g++)
+		zob->cle_grow[g] = zob_rand(&etat);
+	zob->dir[0] = zob->dir[1] = 0;
+	zob->growTime = 0;
+	zob->hash = 0;
+}
+
+// Libère la mémoire des clés
+void zob_free(Zobrist *zob) {
+	free(zob->cle_case);
+	free(zob->cle_grow);
+	zob->cle_case = NULL;
+	zob->cle_grow = NULL;
+}
+
+// Clé d'une case p pour un type d'occupant
+uint64_t zob_cle(const Zobrist *zob, PlanZobrist plan, Pixel p) {
+	assert(p.x >= 0 && p.x < zob->cols && p.y >= 0 && p.y < zob->lines);
+	return zob->cle_case[((size_t)plan * zob->lines + p.y) * zob->cols + p.x];
+}
+
+// Ajoute ou enlève (c'est le même XOR) l'occupant de la case p de l'empreinte
+void zob_toggle(Zobrist *zob, PlanZobrist plan, Pixel p) {
+	zob->hash ^= zob_cle(zob, plan, p);
+}
+
+// Change la direction du serpent numJoueur (1 ou 2) dans l'empreinte
+void zob_set_dir(Zobrist *zob, int numJoueur, int direction) {
+	assert(numJoueur == 1 || numJoueur == 2);
+	int j = numJoueur - 1;
+	zob->hash ^= zob->cle_dir[j][zob->dir[j]] ^ zob->cle_dir[j][direction];
+	zob->dir[j] = direction;
+}
+
+// Change la valeur de growTime dans l'empreinte
+void zob_set_grow(Zobrist *zob, int growTime) {
+	assert(growTime >= 0 && growTime <= zob->growTimeMax);
+	zob->hash ^= zob->cle_grow[zob->growTime] ^ zob->cle_grow[growTime];
+	zob->growTime = growTime;
+}
+
+// Empreinte de la disposition des obstacles seuls
+uint64_t zob_calcule_obst(const Zobrist *zob, Pixel obst[]) {
+	uint64_t hash = 0;
+	for (size_t i = 0; ! is_pix_end(obst[i]); i++)
+		hash ^= zob_cle(zob, PLAN_OBST, obst[i]);
+	return hash;
+}
+
+// Calcule entièrement l'empreinte d'un état, sans la mise à jour incrémentale
+// Sert de référence pour vérifier l'empreinte incrémentale
+uint64_t zob_calcule(const Zobrist *zob, Pixel obst[], Pixel snake1[], Pixel snake2[], int direction1, int direction2, int growTime) {
+	uint64_t hash = zob_calcule_obst(zob, obst);
+	for (size_t i = 0; ! is_pix_end(snake1[i]); i++)
+		hash ^= zob_cle(zob, PLAN_SNAKE1, snake1[i]);
+	for (size_t i = 0; ! is_pix_end(snake2[i]); i++)
+		hash ^= zob_cle(zob, PLAN_SNAKE2, snake2[i]);
+	hash ^= zob->cle_dir[0][direction1] ^ zob->cle_dir[1][direction2];
+	hash ^= zob->cle_grow[growTime];
+	return hash;
+}
+
+// Recalcule l'empreinte à partir d'un état complet
+// A appeler une fois l'état initial construit, ensuite tout est incrémental
+void zob_reset(Zobrist *zob, Pixel obst[], Pixel snake1[], Pixel snake2[], int direction1, int direction2, int growTime) {
+	zob->dir[0] = direction1;
+	zob->dir[1] = direction2;
+	zob->growTime = growTime;
+	zob->hash = zob_calcule(zob, obst, snake1, snake2, direction1, direction2, growTime);
+}
+
+// Variable d'environnement qui donne le fichier de trace des empreintes
+#define ZOBRIST_TRACE_ENV "SNAKE_TRACE"
+
+// Ouvre le fichier de trace des empreintes s'il est demandé dans
+// l'environnement, sinon retourne NULL
+FILE *zob_trace_ouvre() {
+	const char *nom = getenv(ZOBRIST_TRACE_ENV);
+	if (nom == NULL || nom[0] == '\0')
+		return NULL;
+	FILE *trace = fopen(nom, "w");
+	if (trace == NULL)
+		printf("Erreur : impossible d'écrire la trace dans %s\n", nom);
+	return trace;
+}
+
+// Ecrit une ligne "partie mouvement empreinte" dans la trace
+// Deux exécutions qui divergent se repèrent à la première ligne différente
+void zob_trace(FILE *trace, int partie, int mouvement, const Zobrist *zob) {
+	if (trace != NULL)
+		fprintf(trace, "%d %d %016" PRIx64 "\n", partie, mouvement, zob->hash);
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+// Partie obstacles mobiles
+//////////////////////////////////////////////////////////////////////////
+
+// Seuls les obstacles qui bougent sont mis à jour : dans le tableau,
+// dans l'index, dans l'empreinte et à l'écran. Le coût d'un déplacement
+// ne dépend pas du nombre total d'obstacles.
+
+// Nombre d'essais pour trouver une case libre où faire réapparaitre un obstacle
+#define OBST_ESSAIS 10
+
+// Déplacement d'un obstacle, gardé pour pouvoir l'annuler
+typedef struct {
+	unsigned int indice;   // indice de l'obstacle dans le tableau des obstacles
+	Pixel ancien;          // sa position avant le déplacement
+} MouvObst;
+
+// Déplace l'obstacle d'indice i sur la case p
+// Met à jour l'index, l'empreinte et l'affichage des deux seules cases qui changent
+// L'écran n'est pas rafraîchi : l'appelant rafraîchit une fois pour tous les obstacles
+void obst_deplace(Pixel obst[], size_t i, Pixel p, GrilleObst *grille, Zobrist *zob) {
+	Pixel ancien = obst[i];
+	grille_set(grille, ancien, false);
+	zob_toggle(zob, PLAN_OBST, ancien);
+	drawChar(ancien.x, ancien.y, ' ', black);
+	obst[i] = p;
+	grille_set(grille, p, true);
+	zob_toggle(zob, PLAN_OBST, p);
+	drawChar(p.x, p.y, '#', red);
+}
+
+// Vrai si un obstacle peut aller sur la case p : elle est libre et
+// n'est pas juste devant ou à côté de la tête d'un serpent
+bool obst_case_libre(const GrilleObst *grille, Pixel snake1[], Pixel snake2[], Pixel p) {
+	if (!is_pix_in_game(p) || grille_contient(grille, p))
+		return false;
+	if (pix_find(snake1, p) != NOT_FOUND || pix_find(snake2, p) != NOT_FOUND)
+		return false;
+	if (!is_pix_end(snake1[0]) && abs(p.x - snake1[0].x) + abs(p.y - snake1[0].y) <= 1)
+		return false;
+	if (!is_pix_end(snake2[0]) && abs(p.x - snake2[0].x) + abs(p.y - snake2[0].y) <= 1)
+		return false;
+	return true;
+}
+
+// Déplace nb obstacles choisis au hasard parmi les len_obst obstacles
+// Chaque obstacle glisse sur une case voisine, ou réapparait ailleurs
+// si la case voisine n'est pas libre
+// journal: en sortie, les déplacements réalisés (au plus nb)
+// Retourne le nombre d'obstacles déplacés
+// L'écran n'est pas rafraîchi, l'appelant le fait une fois par mouvement
+size_t obst_bouge(Pixel obst[], size_t len_obst, GrilleObst *grille, Pixel snake1[], Pixel snake2[], size_t nb, Zobrist *zob, MouvObst journal[]) {
+	size_t n = 0;
+	if (len_obst == 0)
+		return 0;
+	for (size_t k = 0; k < nb; k++) {
+		size_t i = rand() % len_obst;
+		// Glisse sur une case voisine
+		Pixel p = obst[i];
+		switch (rand() % 4) {
+			case 0: p.y--; break;
+			case 1: p.y++; break;
+			case 2: p.x--; break;
+			case 3: p.x++; break;
+		}
+		// Sinon réapparait au hasard
+		for (int essai = 0; essai < OBST_ESSAIS && !obst_case_libre(grille, snake1, snake2, p); essai++)
+			p = pix_new(rand()%(aire_cols), rand()%(aire_lines));
+		if (!obst_case_libre(grille, snake1, snake2, p))
+			continue;
+		journal[n].indice = i;
+		journal[n].ancien = obst[i];
+		n++;
+		obst_deplace(obst, i, p, grille, zob);
+	}
+	return n;
+}
+
 
 //////////////////////////////////////////////////////////////////////////
 // Partie définition et gestion du serpent (snake)
@@ -193,7 +505,7 @@ void snake_init(Pixel snake[], size_t size, size_t len, int numJoueur) {
 	pix_clear(snake);
 	size_t i = 0;
 	for(i=0; i< len; i++)
-		pix_push_back(snake,size,pix_new(COLS/2+i,LINES/2+numJoueur));
+		pix_push_back(snake,size,pix_new(aire_cols/2+i,aire_lines/2+numJoueur));
 }
 
 // Affiche le serpent
@@ -215,12 +527,27 @@ typedef enum {
 	LEN_MAX       // Le serpent a atteind sa taille adulte (maximale)
 } GameStatus;
 
-// Fait avancer le serpent d'une case et affiche le changement
+// Ce qui change pendant un mouvement des serpents
+// C'est tout ce qu'il faut pour annuler ce mouvement
+typedef struct {
+	Pixel tete[2];           // tête ajoutée par chaque serpent, pix_end s'il n'a pas bougé
+	Pixel queue[2];          // queue enlevée par chaque serpent, pix_end s'il a grandi
+	unsigned char dir[2];    // direction de chaque serpent avant le mouvement
+	unsigned char growTime;  // growTime avant le mouvement
+	unsigned int nb_obst;    // nombre d'obstacles déplacés après le mouvement
+} Delta;
+
+// Fait avancer un seul serpent d'une case et affiche le changement
+// autre: l'autre serpent (chaîne vide en partie à 1 joueur)
+// numJoueur: 1 ou 2, choisit le plan de hachage du serpent qui avance
+// L'empreinte zob est mise à jour avec la tête ajoutée et la queue enlevée
+// qui sont aussi notées dans delta
 // Retourne l'état du jeux apres le mouvement
-GameStatus snake_move(Pixel snake1[], Pixel snake2[], size_t size,Pixel obst[],Direction direction1,Direction direction2,bool grow, char nbr_joueur) {
+GameStatus snake_step(Pixel snake[], Pixel autre[], size_t size, const GrilleObst *grille, Direction direction, bool grow, int numJoueur, Zobrist *zob, Delta *delta) {
+	PlanZobrist plan = (numJoueur == 1) ? PLAN_SNAKE1 : PLAN_SNAKE2;
 	// Test si la nouvelle position est valide
-	Pixel new_snake_head = snake1[0];
-	switch (direction1)
+	Pixel new_snake_head = snake[0];
+	switch (direction)
 	{
 		case versLeHaut: new_snake_head.y--; break;
 		case versLeBas: new_snake_head.y++; break;
@@ -229,52 +556,80 @@ GameStatus snake_move(Pixel snake1[], Pixel snake2[], size_t size,Pixel obst[],D
 	}
 	if(!is_pix_in_game(new_snake_head))
 		return EXIT_SPACE;
-	else if(pix_find(obst, new_snake_head) != NOT_FOUND)
+	else if(grille_contient(grille, new_snake_head))
 		return TOUCH_OBST;
-	if(pix_find(snake1, new_snake_head) != NOT_FOUND || pix_find(snake2, new_snake_head) != NOT_FOUND )
+	if(pix_find(snake, new_snake_head) != NOT_FOUND || pix_find(autre, new_snake_head) != NOT_FOUND )
 		return TOUCH_SNAKE;
-	if((grow)&&(pix_len(snake1) + 1 == size))
+	if((grow)&&(pix_len(snake) + 1 == size))
 		return LEN_MAX;
-	else if (grow)// augmente la len de snake
-		snake1[pix_len(snake1)] = pix_end();
-	if(!grow) {// efface la queue de snake
-		Pixel pix_a_effacer = pix_pop_back(snake1);
+	if(!grow) {// efface la queue de snake, sinon snake garde sa queue et grandit
+		Pixel pix_a_effacer = pix_pop_back(snake);
 		drawPoint(pix_a_effacer.x, pix_a_effacer.y, black);
+		zob_toggle(zob, plan, pix_a_effacer);
+		delta->queue[numJoueur-1] = pix_a_effacer;
 	}
-	// Actualisation de la chaine de pixel snake2
-	pix_push(snake1, size, new_snake_head);
-	snake_draw(snake1);
-	new_snake_head = snake2[0];
-	if(nbr_joueur == '2') {
-		// Test si la nouvelle position est valide
-		switch (direction2)
-		{
-			case versLeHaut: new_snake_head.y--; break;
-			case versLeBas: new_snake_head.y++; break;
-			case versLaGauche: new_snake_head.x--; break;
-			case versLaDroite: new_snake_head.x++; break;
-		}
-		if(!is_pix_in_game(new_snake_head))
-			return EXIT_SPACE;
-		else if(pix_find(obst, new_snake_head) != NOT_FOUND)
-			return TOUCH_OBST;
-		if(pix_find(snake1, new_snake_head) != NOT_FOUND || pix_find(snake2, new_snake_head) != NOT_FOUND )
-			return TOUCH_SNAKE;
-		if((grow)&&(pix_len(snake1) + 1 == size))
-			return LEN_MAX;
-		else if (grow)// augmente la len de snake
-			snake2[pix_len(snake1)] = pix_end();
-		if(!grow) {// efface la queue de snake
-			Pixel pix_a_effacer = pix_pop_back(snake2);
-			drawPoint(pix_a_effacer.x, pix_a_effacer.y, black);
-		}
-		// Actualisation de la chaine de pixel snake
-		pix_push(snake2, size, new_snake_head);
-		snake_draw(snake2);
-	}
+	// Actualisation de la chaine de pixel snake
+	pix_push(snake, size, new_snake_head);
+	zob_toggle(zob, plan, new_snake_head);
+	delta->tete[numJoueur-1] = new_snake_head;
+	zob_set_dir(zob, numJoueur, direction);
+	snake_draw(snake);
 	return GAME_RUNING;
 }
 
+// Fait avancer les serpents d'une case et affiche le changement
+// snake2 n'avance qu'en partie à 2 joueurs
+// grille: l'index des obstacles pour tester les collisions
+// delta: en sortie, ce qui a changé pendant le mouvement
+// Retourne l'état du jeux apres le mouvement
+GameStatus snake_move(Pixel snake1[], Pixel snake2[], size_t size,const GrilleObst *grille,Direction direction1,Direction direction2,bool grow, char nbr_joueur, Zobrist *zob, Delta *delta) {
+	// Note l'état avant le mouvement, l'empreinte le connait déjà
+	for (int j = 0; j < 2; j++) {
+		delta->tete[j] = pix_end();
+		delta->queue[j] = pix_end();
+		delta->dir[j] = zob->dir[j];
+	}
+	delta->growTime = zob->growTime;
+	delta->nb_obst = 0;
+	GameStatus status = snake_step(snake1, snake2, size, grille, direction1, grow, 1, zob, delta);
+	if(status == GAME_RUNING && nbr_joueur == '2')
+		status = snake_step(snake2, snake1, size, grille, direction2, grow, 2, zob, delta);
+	return status;
+}
+
+// Annule le mouvement d'un seul serpent décrit par delta
+// et répare l'affichage des seules cases qui changent, sans rafraîchir l'écran
+void snake_unstep(Pixel snake[], size_t size, const Delta *delta, int numJoueur, Zobrist *zob) {
+	PlanZobrist plan = (numJoueur == 1) ? PLAN_SNAKE1 : PLAN_SNAKE2;
+	Pixel tete = delta->tete[numJoueur-1];
+	Pixel queue = delta->queue[numJoueur-1];
+	if (is_pix_end(tete))
+		return;
+	// Enlève la tête ajoutée
+	assert(pix_equal(snake[0], tete));
+	pix_pop(snake);
+	drawChar(tete.x, tete.y, ' ', black);
+	zob_toggle(zob, plan, tete);
+	// Remet la queue enlevée
+	if (!is_pix_end(queue)) {
+		pix_push_back(snake, size, queue);
+		drawChar(queue.x, queue.y, ACS_CKBOARD|A_ALTCHARSET, green);
+		zob_toggle(zob, plan, queue);
+	}
+	// L'ancien cou redevient la tête
+	drawChar(snake[0].x, snake[0].y, ACS_DIAMOND|A_ALTCHARSET, green);
+	zob_set_dir(zob, numJoueur, delta->dir[numJoueur-1]);
+}
+
+// Annule un mouvement des serpents décrit par delta
+// snake2 est remis en premier car il a bougé en dernier :
+// il a pu prendre la case de la queue que snake1 venait de libérer
+void snake_unmove(Pixel snake1[], Pixel snake2[], size_t size, const Delta *delta, Zobrist *zob) {
+	snake_unstep(snake2, size, delta, 2, zob);
+	snake_unstep(snake1, size, delta, 1, zob);
+	zob_set_grow(zob, delta->growTime);
+}
+
 // Calcule la nouvelle direction à suivre si on tourne à droite
 // à partir de la valeur direction
 Direction turnRight(Direction direction) {
@@ -302,6 +657,841 @@ Direction turnLeft(Direction direction) {
 }
 
 
+//////////////////////////////////////////////////////////////////////////
+// Partie historique des mouvements pour revenir en arrière
+//////////////////////////////////////////////////////////////////////////
+
+// Durée de l'historique conservé en secondes
+#define HISTO_SECONDES 3600
+// Durée du retour en arrière demandé par la touche 'r' en secondes
+#define REWIND_SECONDES 5
+
+// Historique des derniers mouvements dans un tampon circulaire
+// Quand il est plein, le mouvement le plus ancien est oublié
+// Les déplacements d'obstacles de chaque mouvement sont dans un second
+// tampon circulaire, le Delta du mouvement en donne le nombre
+typedef struct {
+	Delta *deltas;          // tableau de capacite mouvements
+	size_t capacite;        // nombre maximum de mouvements conservés
+	size_t debut;           // indice du mouvement le plus ancien
+	size_t nb;              // nombre de mouvements conservés
+	MouvObst *mouv_obst;    // tableau de capacite_obst déplacements d'obstacles
+	size_t capacite_obst;   // nombre maximum de déplacements conservés
+	size_t debut_obst;      // indice du déplacement le plus ancien
+	size_t nb_obst;         // nombre de déplacements conservés
+} Historique;
+
+// Initialise un historique vide pouvant garder capacite mouvements
+// et capacite_obst déplacements d'obstacles
+void histo_init(Historique *histo, size_t capacite, size_t capacite_obst) {
+	assert(capacite >= 1);
+	// Au moins une case pour que malloc ne retourne pas NULL
+	if (capacite_obst == 0)
+		capacite_obst = 1;
+	histo->deltas = malloc(capacite * sizeof(Delta));
+	histo->mouv_obst = malloc(capacite_obst * sizeof(MouvObst));
+	if (histo->deltas == NULL || histo->mouv_obst == NULL) {
+		printf("Erreur : mémoire insuffisante pour l'historique\n");
+		exit(1);
+	}
+	histo->capacite = capacite;
+	histo->debut = 0;
+	histo->nb = 0;
+	histo->capacite_obst = capacite_obst;
+	histo->debut_obst = 0;
+	histo->nb_obst = 0;
+}
+
+// Libère la mémoire de l'historique
+void histo_free(Historique *histo) {
+	free(histo->deltas);
+	free(histo->mouv_obst);
+	histo->deltas = NULL;
+	histo->mouv_obst = NULL;
+	histo->capacite = 0;
+	histo->nb = 0;
+	histo->capacite_obst = 0;
+	histo->nb_obst = 0;
+}
+
+// Oublie le mouvement le plus ancien et ses déplacements d'obstacles
+void histo_oublie(Historique *histo) {
+	assert(histo->nb >= 1);
+	const Delta *ancien = &histo->deltas[histo->debut];
+	assert(ancien->nb_obst <= histo->nb_obst);
+	histo->debut_obst = (histo->debut_obst + ancien->nb_obst) % histo->capacite_obst;
+	histo->nb_obst -= ancien->nb_obst;
+	histo->debut = (histo->debut + 1) % histo->capacite;
+	histo->nb--;
+}
+
+// Ajoute le dernier mouvement à l'historique
+// Ses déplacements d'obstacles doivent déjà être ajoutés par histo_push_obst
+void histo_push(Historique *histo, const Delta *delta) {
+	if (histo->nb == histo->capacite) // plein : oublie le plus ancien
+		histo_oublie(histo);
+	histo->deltas[(histo->debut + histo->nb) % histo->capacite] = *delta;
+	histo->nb++;
+}
+
+// Ajoute un déplacement d'obstacle du mouvement en cours à l'historique
+// Oublie les mouvements les plus anciens s'il n'y a plus de place
+void histo_push_obst(Historique *histo, const MouvObst *mouv) {
+	while (histo->nb_obst == histo->capacite_obst)
+		histo_oublie(histo);
+	histo->mouv_obst[(histo->debut_obst + histo->nb_obst) % histo->capacite_obst] = *mouv;
+	histo->nb_obst++;
+}
+
+// Enlève le dernier déplacement d'obstacle de l'historique
+void histo_pop_obst(Historique *histo, MouvObst *mouv) {
+	assert(histo->nb_obst >= 1);
+	histo->nb_obst--;
+	*mouv = histo->mouv_obst[(histo->debut_obst + histo->nb_obst) % histo->capacite_obst];
+}
+
+// Enlève le dernier mouvement de l'historique
+// Retourne faux si l'historique est vide
+bool histo_pop(Historique *histo, Delta *delta) {
+	if (histo->nb == 0)
+		return false;
+	histo->nb--;
+	*delta = histo->deltas[(histo->debut + histo->nb) % histo->capacite];
+	return true;
+}
+
+// Revient en arrière d'au plus nb_mouvements mouvements
+// Les obstacles déplacés pendant ces mouvements reprennent leur place
+// Retourne le nombre de mouvements effectivement annulés
+int partie_rewind(Historique *histo, Pixel snake1[], Pixel snake2[], size_t size, Pixel obst[], GrilleObst *grille, int nb_mouvements, Zobrist *zob) {
+	Delta delta;
+	MouvObst mouv;
+	int n = 0;
+	while (n < nb_mouvements && histo_pop(histo, &delta)) {
+		// Les obstacles ont bougé après les serpents : ils sont remis en premier
+		for (size_t k = 0; k < delta.nb_obst; k++) {
+			histo_pop_obst(histo, &mouv);
+			obst_deplace(obst, mouv.indice, mouv.ancien, grille, zob);
+		}
+		snake_unmove(snake1, snake2, size, &delta, zob);
+		n++;
+	}
+	refresh();
+	return n;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Partie solveur : snake1 suit un cycle hamiltonien
+//////////////////////////////////////////////////////////////////////////
+
+// Le jeux est découpé en blocs de 2x2 cases. Un arbre couvrant relie les blocs
+// sans obstacle accessibles depuis le départ de snake1. Faire le tour de cet
+// arbre en longeant ses bords passe une fois et une seule par chaque case de
+// ses blocs : c'est un cycle hamiltonien de ces cases. Un serpent qui suit ce
+// cycle ne peut pas se mordre tant qu'il est plus court que le cycle.
+
+// Dossier du cache des cycles, dans $XDG_CACHE_HOME ou à défaut $HOME/.cache
+#define CYCLE_CACHE_DOSSIER "snake"
+// Préfixe des fichiers de cache des cycles
+#define CYCLE_CACHE_PREFIXE "cycle_"
+// Nombre maximum de cycles gardés en cache, les plus anciens sont supprimés
+#define CYCLE_CACHE_MAX 32
+// Longueur maximum des chemins du cache
+#define PATH_CACHE_MAX 4096
+// Identifie un fichier de cache de cycle
+#define CYCLE_CACHE_MAGIC 0x534e4b43
+
+// Arêtes de l'arbre couvrant vers les blocs voisins
+#define ARETE_HAUT   1
+#define ARETE_BAS    2
+#define ARETE_GAUCHE 4
+#define ARETE_DROITE 8
+
+// Un cycle hamiltonien sur une partie des cases du jeux
+typedef struct {
+	int cols;        // largeur du jeux du cycle
+	int lines;       // hauteur du jeux du cycle
+	size_t len;      // nombre de cases du cycle
+	int *rang;       // rang de chaque case dans le cycle, -1 hors du cycle
+	Pixel *cases;    // les cases dans l'ordre du cycle
+} Cycle;
+
+// Alloue un cycle vide pour la taille courante du jeux (aire_cols x aire_lines)
+void cycle_init(Cycle *cycle) {
+	size_t nb_cases = (size_t)aire_cols * aire_lines;
+	cycle->cols = aire_cols;
+	cycle->lines = aire_lines;
+	cycle->len = 0;
+	cycle->rang = malloc(nb_cases * sizeof(int));
+	cycle->cases = malloc(nb_cases * sizeof(Pixel));
+	if (cycle->rang == NULL || cycle->cases == NULL) {
+		printf("Erreur : mémoire insuffisante pour le cycle hamiltonien\n");
+		exit(1);
+	}
+	for (size_t i = 0; i < nb_cases; i++)
+		cycle->rang[i] = -1;
+}
+
+// Libère la mémoire du cycle
+void cycle_free(Cycle *cycle) {
+	free(cycle->rang);
+	free(cycle->cases);
+	cycle->rang = NULL;
+	cycle->cases = NULL;
+	cycle->len = 0;
+}
+
+// Rang de la case p dans le cycle, -1 si p n'est pas dans le cycle
+int cycle_rang(const Cycle *cycle, Pixel p) {
+	if (p.x < 0 || p.x >= cycle->cols || p.y < 0 || p.y >= cycle->lines)
+		return -1;
+	return cycle->rang[p.y * cycle->cols + p.x];
+}
+
+// Case qui suit p en faisant le tour de l'arbre couvrant des blocs
+// aretes: les arêtes de chaque bloc, nb_blocs_x: nombre de blocs par ligne
+Pixel cycle_suivant_arbre(const unsigned char aretes[], int nb_blocs_x, Pixel p) {
+	unsigned char a = aretes[(p.y/2) * nb_blocs_x + p.x/2];
+	// Sens inverse des aiguilles d'une montre dans le bloc, sauf pour
+	// passer dans un bloc voisin relié par une arête
+	if (p.x%2 == 0 && p.y%2 == 0) // en haut à gauche
+		return (a & ARETE_GAUCHE) ? pix_new(p.x-1,p.y) : pix_new(p.x,p.y+1);
+	if (p.x%2 == 0) // en bas à gauche
+		return (a & ARETE_BAS) ? pix_new(p.x,p.y+1) : pix_new(p.x+1,p.y);
+	if (p.y%2 == 1) // en bas à droite
+		return (a & ARETE_DROITE) ? pix_new(p.x+1,p.y) : pix_new(p.x,p.y-1);
+	// en haut à droite
+	return (a & ARETE_HAUT) ? pix_new(p.x,p.y-1) : pix_new(p.x-1,p.y);
+}
+
+// Calcule un cycle hamiltonien des blocs sans obstacle accessibles
+// depuis le bloc le plus proche de la case depart
+// Le cycle est vide s'il n'y a aucun bloc sans obstacle
+void cycle_calcule(Cycle *cycle, Pixel obst[], Pixel depart) {
+	int nb_blocs_x = cycle->cols / 2;
+	int nb_blocs_y = cycle->lines / 2;
+	size_t nb_blocs = (size_t)nb_blocs_x * nb_blocs_y;
+	cycle->len = 0;
+	if (nb_blocs == 0)
+		return;
+	bool *libre = malloc(nb_blocs * sizeof(bool));
+	unsigned char *aretes = calloc(nb_blocs, sizeof(unsigned char));
+	bool *vu = calloc(nb_blocs, sizeof(bool));
+	size_t *file = malloc(nb_blocs * sizeof(size_t));
+	if (libre == NULL || aretes == NULL || vu == NULL || file == NULL) {
+		printf("Erreur : mémoire insuffisante pour le cycle hamiltonien\n");
+		exit(1);
+	}
+	// Un bloc est libre s'il ne contient aucun obstacle
+	for (size_t b = 0; b < nb_blocs; b++)
+		libre[b] = true;
+	for (size_t i = 0; ! is_pix_end(obst[i]); i++)
+		if (obst[i].x / 2 < nb_blocs_x && obst[i].y / 2 < nb_blocs_y)
+			libre[(obst[i].y/2) * nb_blocs_x + obst[i].x/2] = false;
+	// Le bloc racine est le bloc libre le plus proche du départ
+	size_t racine = nb_blocs;
+	int dist_min = 0;
+	for (size_t b = 0; b < nb_blocs; b++) {
+		int dist = abs((int)(b % nb_blocs_x) - depart.x/2) + abs((int)(b / nb_blocs_x) - depart.y/2);
+		if (libre[b] && (racine == nb_blocs || dist < dist_min)) {
+			racine = b;
+			dist_min = dist;
+		}
+	}
+	if (racine < nb_blocs) {
+		// Parcours en largeur des blocs libres : construit l'arbre couvrant
+		size_t debut = 0, fin = 0;
+		file[fin++] = racine;
+		vu[racine] = true;
+		while (debut < fin) {
+			size_t b = file[debut++];
+			int bx = b % nb_blocs_x, by = b / nb_blocs_x;
+			// voisins : haut, bas, gauche, droite
+			int vx[4] = {bx, bx, bx-1, bx+1};
+			int vy[4] = {by-1, by+1, by, by};
+			unsigned char vers[4] = {ARETE_HAUT, ARETE_BAS, ARETE_GAUCHE, ARETE_DROITE};
+			unsigned char retour[4] = {ARETE_BAS, ARETE_HAUT, ARETE_DROITE, ARETE_GAUCHE};
+			for (int v = 0; v < 4; v++) {
+				if (vx[v] < 0 || vx[v] >= nb_blocs_x || vy[v] < 0 || vy[v] >= nb_blocs_y)
+					continue;
+				size_t nb = (size_t)vy[v] * nb_blocs_x + vx[v];
+				if (libre[nb] && !vu[nb]) {
+					vu[nb] = true;
+					aretes[b] |= vers[v];
+					aretes[nb] |= retour[v];
+					file[fin++] = nb;
+				}
+			}
+		}
+		// Fait le tour de l'arbre depuis le coin en haut à gauche de la racine
+		Pixel p = pix_new((racine % nb_blocs_x) * 2, (racine / nb_blocs_x) * 2);
+		do {
+			cycle->rang[p.y * cycle->cols + p.x] = cycle->len;
+			cycle->cases[cycle->len++] = p;
+			p = cycle_suivant_arbre(aretes, nb_blocs_x, p);
+		} while (cycle_rang(cycle, p) < 0);
+		// Le tour revient à son départ après 4 cases par bloc de l'arbre
+		assert(cycle_rang(cycle, p) == 0);
+		assert(cycle->len == 4 * fin);
+	}
+	free(libre);
+	free(aretes);
+	free(vu);
+	free(file);
+}
+
+// Crée si besoin le dossier de cache des cycles et écrit son chemin dans dossier
+// Retourne faux s'il n'y a pas de dossier de cache utilisable
+bool cycle_dossier_cache(char dossier[], size_t size) {
+	const char *base = getenv("XDG_CACHE_HOME");
+	int n;
+	if (base != NULL && base[0] != '\0') {
+		n = snprintf(dossier, size, "%s", base);
+	} else {
+		base = getenv("HOME");
+		if (base == NULL || base[0] == '\0')
+			return false;
+		n = snprintf(dossier, size, "%s/.cache", base);
+	}
+	if (n < 0 || (size_t)n >= size)
+		return false;
+	// Le dossier parent peut ne pas exister encore
+	mkdir(dossier, 0700);
+	int m = snprintf(dossier + n, size - n, "/%s", CYCLE_CACHE_DOSSIER);
+	if (m < 0 || (size_t)m >= size - n)
+		return false;
+	mkdir(dossier, 0700);
+	struct stat info;
+	return stat(dossier, &info) == 0 && S_ISDIR(info.st_mode);
+}
+
+// Nom du fichier de cache d'un cycle : taille du jeux et empreinte des obstacles
+// Retourne faux si le nom est trop long
+bool cycle_nom_cache(char nom[], size_t size, const char dossier[], int cols, int lines, uint64_t hash_obst) {
+	int n = snprintf(nom, size, "%s/%s%dx%d_%016" PRIx64, dossier, CYCLE_CACHE_PREFIXE, cols, lines, hash_obst);
+	return n >= 0 && (size_t)n < size;
+}
+
+// Supprime les cycles les plus anciens jusqu'à en garder au plus CYCLE_CACHE_MAX
+void cycle_nettoie_cache(const char dossier[]) {
+	char nom[PATH_CACHE_MAX];
+	char plus_ancien[PATH_CACHE_MAX];
+	for (;;) {
+		DIR *d = opendir(dossier);
+		if (d == NULL)
+			return;
+		int nb = 0;
+		time_t date_ancien = 0;
+		struct dirent *entree;
+		while ((entree = readdir(d)) != NULL) {
+			struct stat info;
+			if (strncmp(entree->d_name, CYCLE_CACHE_PREFIXE, strlen(CYCLE_CACHE_PREFIXE)) != 0)
+				continue;
+			int n = snprintf(nom, sizeof(nom), "%s/%s", dossier, entree->d_name);
+			if (n < 0 || (size_t)n >= sizeof(nom) || stat(nom, &info) != 0)
+				continue;
+			if (nb == 0 || info.st_mtime < date_ancien) {
+				date_ancien = info.st_mtime;
+				strcpy(plus_ancien, nom);
+			}
+			nb++;
+		}
+		closedir(d);
+		if (nb <= CYCLE_CACHE_MAX || remove(plus_ancien) != 0)
+			return;
+	}
+}
+
+// Ecrit le cycle dans le fichier f
+// Retourne faux si l'écriture a échoué
+bool cycle_ecrit(const Cycle *cycle, uint64_t hash_obst, FILE *f) {
+	uint32_t entete[4] = {CYCLE_CACHE_MAGIC, (uint32_t)cycle->cols, (uint32_t)cycle->lines, (uint32_t)cycle->len};
+	return fwrite(entete, sizeof(entete), 1, f) == 1
+		&& fwrite(&hash_obst, sizeof(hash_obst), 1, f) == 1
+		&& fwrite(cycle->cases, sizeof(Pixel), cycle->len, f) == cycle->len
+		&& fflush(f) == 0;
+}
+
+// Lit le cycle depuis le fichier f
+// Retourne faux si le fichier ne correspond pas au jeux ou n'est pas un cycle
+bool cycle_lit(Cycle *cycle, uint64_t hash_obst, FILE *f) {
+	uint32_t entete[4];
+	uint64_t hash_lu;
+	size_t nb_cases = (size_t)cycle->cols * cycle->lines;
+	bool ok = fread(entete, sizeof(entete), 1, f) == 1
+		&& fread(&hash_lu, sizeof(hash_lu), 1, f) == 1
+		&& entete[0] == CYCLE_CACHE_MAGIC
+		&& entete[1] == (uint32_t)cycle->cols && entete[2] == (uint32_t)cycle->lines
+		&& entete[3] <= nb_cases && hash_lu == hash_obst
+		&& fread(cycle->cases, sizeof(Pixel), entete[3], f) == entete[3];
+	for (size_t i = 0; i < nb_cases; i++)
+		cycle->rang[i] = -1;
+	cycle->len = 0;
+	if (!ok)
+		return false;
+	// Reconstruit les rangs et vérifie que c'est bien un cycle de cases voisines
+	for (size_t i = 0; i < entete[3]; i++) {
+		Pixel p = cycle->cases[i];
+		Pixel q = cycle->cases[(i+1) % entete[3]];
+		if (p.x < 0 || p.x >= cycle->cols || p.y < 0 || p.y >= cycle->lines
+			|| abs(p.x-q.x) + abs(p.y-q.y) != 1 || cycle->rang[p.y * cycle->cols + p.x] >= 0) {
+			for (size_t j = 0; j < nb_cases; j++)
+				cycle->rang[j] = -1;
+			return false;
+		}
+		cycle->rang[p.y * cycle->cols + p.x] = i;
+	}
+	cycle->len = entete[3];
+	return true;
+}
+
+// Enregistre le cycle dans le cache puis limite la taille du cache
+// Le fichier est écrit à côté puis renommé : un cache à moitié écrit n'est
+// jamais lu. Un cache qui ne peut pas être écrit est simplement ignoré
+void cycle_sauve(const Cycle *cycle, uint64_t hash_obst) {
+	char dossier[PATH_CACHE_MAX];
+	char nom[PATH_CACHE_MAX];
+	char provisoire[PATH_CACHE_MAX];
+	if (!cycle_dossier_cache(dossier, sizeof(dossier))
+		|| !cycle_nom_cache(nom, sizeof(nom), dossier, cycle->cols, cycle->lines, hash_obst))
+		return;
+	int n = snprintf(provisoire, sizeof(provisoire), "%s.tmp", nom);
+	if (n < 0 || (size_t)n >= sizeof(provisoire))
+		return;
+	FILE *f = fopen(provisoire, "wb");
+	if (f == NULL)
+		return;
+	bool ok = cycle_ecrit(cycle, hash_obst, f);
+	ok = (fclose(f) == 0) && ok;
+	if (!ok || rename(provisoire, nom) != 0) {
+		remove(provisoire);
+		return;
+	}
+	cycle_nettoie_cache(dossier);
+}
+
+// Charge le cycle depuis le cache
+// Retourne faux si le cache n'existe pas ou ne correspond pas au jeux
+bool cycle_charge(Cycle *cycle, uint64_t hash_obst) {
+	char dossier[PATH_CACHE_MAX];
+	char nom[PATH_CACHE_MAX];
+	if (!cycle_dossier_cache(dossier, sizeof(dossier))
+		|| !cycle_nom_cache(nom, sizeof(nom), dossier, cycle->cols, cycle->lines, hash_obst))
+		return false;
+	FILE *f = fopen(nom, "rb");
+	if (f == NULL)
+		return false;
+	bool ok = cycle_lit(cycle, hash_obst, f);
+	fclose(f);
+	return ok;
+}
+
+// Charge le cycle du jeux depuis le cache, ou le calcule puis le met en cache
+// hash_obst: l'empreinte de la disposition des obstacles
+void cycle_prepare(Cycle *cycle, Pixel obst[], Pixel depart, uint64_t hash_obst) {
+	if (cycle_charge(cycle, hash_obst))
+		return;
+	cycle_calcule(cycle, obst, depart);
+	cycle_sauve(cycle, hash_obst);
+}
+
+// Nombre de mouvements au bout desquels la case d'indice i du serpent est
+// libérée par la queue. Le serpent grandit au mouvement growTime + 1 puis
+// tous les growTimeMax + 1 mouvements, et la queue n'avance pas quand il grandit.
+size_t solveur_liberation(size_t len, size_t i, int growTime, int growTimeMax) {
+	size_t m = len - i; // nombre de mouvements sans grandir nécessaires
+	if (m <= (size_t)growTime)
+		return m;
+	if (growTimeMax <= 0) // le serpent grandit à chaque mouvement
+		return (size_t)-1;
+	return m + (m - growTime + growTimeMax - 1) / growTimeMax;
+}
+
+// Vrai si la tête peut aller sur la case n du cycle sans risque :
+// en suivant ensuite le cycle, chaque case du corps est libérée avant
+// que la tête ne l'atteigne
+bool solveur_sans_risque(const Cycle *cycle, Pixel snake[], Pixel n, int growTime, int growTimeMax) {
+	int rang_n = cycle_rang(cycle, n);
+	size_t len = pix_len(snake);
+	for (size_t i = 0; i < len; i++) {
+		int rang_b = cycle_rang(cycle, snake[i]);
+		if (rang_b < 0) // hors du cycle, la tête ne passera jamais dessus
+			continue;
+		size_t distance = (rang_b - rang_n + cycle->len) % cycle->len;
+		if (distance < solveur_liberation(len, i, growTime, growTimeMax))
+			return false;
+	}
+	return true;
+}
+
+// Choisit la direction de snake1 pour le mouvement suivant
+// growTime: le compteur de grossissement avant ce mouvement
+// Le serpent suit le cycle. Quand la case suivante du cycle n'est pas
+// possible et que le serpent est court, il prend un raccourci sans risque
+// vers la case la plus proche devant lui dans le cycle.
+Direction solveur_direction(const Cycle *cycle, Pixel snake[], const GrilleObst *grille, Direction direction, int growTime, int growTimeMax) {
+	Direction candidats[3] = {direction, turnLeft(direction), turnRight(direction)};
+	int rang_tete = cycle_rang(cycle, snake[0]);
+	bool court = 2 * pix_len(snake) <= cycle->len;
+	Direction meilleur = direction;
+	size_t meilleur_score = (size_t)-1;
+	for (int c = 0; c < 3; c++) {
+		Pixel n = snake[0];
+		switch (candidats[c]) {
+			case versLeHaut: n.y--; break;
+			case versLeBas: n.y++; break;
+			case versLaGauche: n.x--; break;
+			case versLaDroite: n.x++; break;
+		}
+		if (!is_pix_in_game(n) || grille_contient(grille, n) || pix_find(snake, n) != NOT_FOUND)
+			continue;
+		int rang_n = cycle_rang(cycle, n);
+		// Score : plus il est petit, meilleur est le mouvement
+		size_t score;
+		if (rang_n < 0 || !solveur_sans_risque(cycle, snake, n, growTime, growTimeMax))
+			score = 3 * cycle->len + 1;  // case libre mais risquée : en dernier recours
+		else if (rang_tete < 0)
+			score = 2 * cycle->len;      // rejoint le cycle
+		else {
+			size_t avance = (rang_n - rang_tete + cycle->len) % cycle->len;
+			if (avance == 1)
+				score = 0;               // case suivante du cycle
+			else if (court)
+				score = avance;          // raccourci sans risque
+			else
+				score = 2 * cycle->len;
+		}
+		if (score < meilleur_score) {
+			meilleur = candidats[c];
+			meilleur_score = score;
+		}
+	}
+	return meilleur;
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+// Partie robots (bots) chargés depuis une bibliothèque partagée
+//////////////////////////////////////////////////////////////////////////
+
+// Un robot reçoit une vue du jeux en lecture seule et répond s'il tourne.
+// Il dispose d'une partie du temps d'un mouvement : une réponse plus lente
+// est ignorée, le serpent continue tout droit et le retard est compté.
+// Le robot est appelé dans son propre fil d'exécution (thread) pour que le
+// jeux n'attende jamais plus que ce temps, même si le robot ne répond pas.
+
+// Part du temps d'un mouvement (gameSpeed) laissée au robot pour répondre
+#define BOT_BUDGET_POURCENT 50
+
+// Echange entre le jeux et le fil d'exécution d'un robot
+// Tout est protégé par verrou. Le fil du robot travaille sur sa propre copie
+// de la vue : le jeux peut continuer pendant qu'un robot trop lent calcule.
+typedef struct {
+	pthread_t fil;
+	pthread_mutex_t verrou;
+	pthread_cond_t demande;     // signalé quand une vue est prête ou à l'arrêt
+	pthread_cond_t reponse;     // signalé quand le robot a répondu
+	SnakeBotFonction tourne;    // la fonction snake_bot_tourne du robot
+	bool prete;                 // une vue attend le robot
+	bool occupe;                // le robot n'a pas encore répondu à la dernière vue
+	bool arret;                 // le fil doit s'arrêter
+	bool abandonne;             // le robot a été libéré pendant un calcul
+	void *bibliotheque;         // à fermer par le fil si le robot est abandonné
+	BotVue vue;                 // copie de la vue donnée au robot
+	bool *obstacle;             // copie des obstacles de la vue
+	size_t capacite_obstacle;
+	BotCase *moi;               // copie du serpent du robot
+	size_t capacite_moi;
+	BotCase *adversaire;        // copie de l'autre serpent
+	size_t capacite_adversaire;
+	BotTourne resultat;         // réponse du robot à la dernière vue
+	double debut;               // début du dernier appel du robot
+	double latence;             // durée de la dernière réponse en microsecondes
+} BotAppel;
+
+// Un robot et ses statistiques
+typedef struct {
+	const char *chemin;         // fichier .so du robot
+	void *bibliotheque;         // bibliothèque ouverte par dlopen, NULL sinon
+	SnakeBotFonction tourne;    // la fonction snake_bot_tourne du robot
+	BotAppel *appel;            // fil d'exécution qui appelle le robot
+	size_t nb_coups;            // nombre de réponses demandées
+	size_t nb_hors_delai;       // nombre de réponses arrivées trop tard
+	double *latences;           // durée de chaque réponse en microsecondes
+	size_t capacite_latences;   // nombre de cases du tableau latences
+} Bot;
+
+// Temps courant en microsecondes, pour mesurer des durées
+double temps_us() {
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec * 1e6 + t.tv_nsec / 1e3;
+}
+
+// Temps de réponse maximum d'un robot pour une vitesse de jeux
+long bot_budget_us(int gameSpeed) {
+	return gameSpeed * 1000L * BOT_BUDGET_POURCENT / 100;
+}
+
+// Libère l'échange avec le fil d'un robot, une fois le fil arrêté
+void bot_appel_free(BotAppel *appel) {
+	if (appel->bibliotheque != NULL)
+		dlclose(appel->bibliotheque);
+	pthread_mutex_destroy(&appel->verrou);
+	pthread_cond_destroy(&appel->demande);
+	pthread_cond_destroy(&appel->reponse);
+	free(appel->obstacle);
+	free(appel->moi);
+	free(appel->adversaire);
+	free(appel);
+}
+
+// Fil d'exécution d'un robot : appelle le robot à chaque vue prête
+// Si le robot est abandonné pendant un calcul, le fil libère l'échange
+void *bot_fil(void *argument) {
+	BotAppel *appel = argument;
+	pthread_mutex_lock(&appel->verrou);
+	for (;;) {
+		while (!appel->prete && !appel->arret)
+			pthread_cond_wait(&appel->demande, &appel->verrou);
+		if (appel->arret)
+			break;
+		appel->prete = false;
+		pthread_mutex_unlock(&appel->verrou);
+		// La vue n'est pas modifiée par le jeux tant que occupe est vrai
+		BotTourne resultat = appel->tourne(&appel->vue);
+		double fin = temps_us();
+		pthread_mutex_lock(&appel->verrou);
+		appel->resultat = resultat;
+		appel->latence = fin - appel->debut;
+		appel->occupe = false;
+		pthread_cond_signal(&appel->reponse);
+		if (appel->abandonne)
+			break;
+	}
+	bool abandonne = appel->abandonne;
+	pthread_mutex_unlock(&appel->verrou);
+	if (abandonne)
+		bot_appel_free(appel);
+	return NULL;
+}
+
+// Initialise un robot dont la fonction est déjà connue et démarre son fil
+void bot_init(Bot *bot, const char *chemin, SnakeBotFonction tourne) {
+	bot->chemin = chemin;
+	bot->bibliotheque = NULL;
+	bot->tourne = tourne;
+	bot->nb_coups = 0;
+	bot->nb_hors_delai = 0;
+	bot->latences = NULL;
+	bot->capacite_latences = 0;
+	BotAppel *appel = calloc(1, sizeof(BotAppel));
+	if (appel == NULL) {
+		printf("Erreur : mémoire insuffisante pour le robot\n");
+		exit(1);
+	}
+	appel->tourne = tourne;
+	// Les délais sont comptés sur l'horloge monotone, comme temps_us
+	pthread_condattr_t attributs;
+	pthread_condattr_init(&attributs);
+	pthread_condattr_setclock(&attributs, CLOCK_MONOTONIC);
+	pthread_mutex_init(&appel->verrou, NULL);
+	pthread_cond_init(&appel->demande, NULL);
+	pthread_cond_init(&appel->reponse, &attributs);
+	pthread_condattr_destroy(&attributs);
+	if (pthread_create(&appel->fil, NULL, bot_fil, appel) != 0) {
+		printf("Erreur : impossible de démarrer le robot %s\n", chemin);
+		exit(1);
+	}
+	bot->appel = appel;
+}
+
+// Charge un robot depuis son fichier .so
+// Retourne faux, avec la raison dans erreur, si le fichier ou la fonction manque
+bool bot_charge(Bot *bot, const char *chemin, char erreur[], size_t size) {
+	void *bibliotheque = dlopen(chemin, RTLD_NOW | RTLD_LOCAL);
+	if (bibliotheque == NULL) {
+		snprintf(erreur, size, "impossible de charger le robot %s : %s", chemin, dlerror());
+		return false;
+	}
+	SnakeBotFonction tourne = (SnakeBotFonction)dlsym(bibliotheque, SNAKE_BOT_SYMBOLE);
+	if (tourne == NULL) {
+		snprintf(erreur, size, "le robot %s ne définit pas %s", chemin, SNAKE_BOT_SYMBOLE);
+		dlclose(bibliotheque);
+		return false;
+	}
+	bot_init(bot, chemin, tourne);
+	bot->bibliotheque = bibliotheque;
+	return true;
+}
+
+// Arrête le fil du robot, ferme sa bibliothèque et libère ses statistiques
+// Un robot qui calcule encore n'est pas attendu : son fil finit seul
+void bot_free(Bot *bot) {
+	BotAppel *appel = bot->appel;
+	pthread_mutex_lock(&appel->verrou);
+	if (appel->occupe) {
+		// Après le déverrouillage, appel peut déjà être libéré par le fil
+		pthread_t fil = appel->fil;
+		appel->abandonne = true;
+		appel->bibliotheque = bot->bibliotheque;
+		pthread_mutex_unlock(&appel->verrou);
+		pthread_detach(fil);
+	} else {
+		appel->arret = true;
+		pthread_cond_signal(&appel->demande);
+		pthread_mutex_unlock(&appel->verrou);
+		pthread_join(appel->fil, NULL);
+		appel->bibliotheque = bot->bibliotheque;
+		bot_appel_free(appel);
+	}
+	free(bot->latences);
+	bot->appel = NULL;
+	bot->bibliotheque = NULL;
+	bot->tourne = NULL;
+	bot->latences = NULL;
+	bot->capacite_latences = 0;
+}
+
+// Remplit la vue donnée au robot qui dirige snake
+// empreinte: l'empreinte de Zobrist de l'état du jeux
+// moi, adversaire: tableaux où sont copiés les serpents, de la taille des serpents
+void bot_vue(BotVue *vue, const GrilleObst *grille, Pixel snake[], Pixel autre[], BotCase moi[], BotCase adversaire[], Direction direction, Direction direction_autre, int growTime, int mouvement, uint64_t empreinte, long budget_us) {
+	size_t i;
+	for (i = 0; ! is_pix_end(snake[i]); i++) {
+		moi[i].x = snake[i].x;
+		moi[i].y = snake[i].y;
+	}
+	vue->len_moi = i;
+	for (i = 0; ! is_pix_end(autre[i]); i++) {
+		adversaire[i].x = autre[i].x;
+		adversaire[i].y = autre[i].y;
+	}
+	vue->len_adversaire = i;
+	vue->version = SNAKE_BOT_VERSION;
+	vue->cols = grille->cols;
+	vue->lines = grille->lines;
+	vue->obstacle = grille->occupe;
+	vue->moi = moi;
+	vue->adversaire = adversaire;
+	vue->direction = (BotDirection)direction;
+	vue->direction_adversaire = (BotDirection)direction_autre;
+	vue->growTime = growTime;
+	vue->mouvement = mouvement;
+	vue->empreinte = empreinte;
+	vue->budget_us = budget_us;
+}
+
+// Agrandit si besoin un tableau pour qu'il contienne len cases de taille taille
+void *bot_reserve(void *tableau, size_t *capacite, size_t len, size_t taille) {
+	if (len <= *capacite)
+		return tableau;
+	tableau = realloc(tableau, len * taille);
+	if (tableau == NULL) {
+		printf("Erreur : mémoire insuffisante pour la vue du robot\n");
+		exit(1);
+	}
+	*capacite = len;
+	return tableau;
+}
+
+// Copie la vue et ses tableaux dans l'échange avec le fil du robot
+// Le robot ne doit pas être occupé
+void bot_copie_vue(BotAppel *appel, const BotVue *vue) {
+	size_t nb_cases = (size_t)vue->cols * vue->lines;
+	appel->obstacle = bot_reserve(appel->obstacle, &appel->capacite_obstacle, nb_cases, sizeof(bool));
+	appel->moi = bot_reserve(appel->moi, &appel->capacite_moi, vue->len_moi, sizeof(BotCase));
+	appel->adversaire = bot_reserve(appel->adversaire, &appel->capacite_adversaire, vue->len_adversaire, sizeof(BotCase));
+	if (nb_cases > 0)
+		memcpy(appel->obstacle, vue->obstacle, nb_cases * sizeof(bool));
+	if (vue->len_moi > 0)
+		memcpy(appel->moi, vue->moi, vue->len_moi * sizeof(BotCase));
+	if (vue->len_adversaire > 0)
+		memcpy(appel->adversaire, vue->adversaire, vue->len_adversaire * sizeof(BotCase));
+	appel->vue = *vue;
+	appel->vue.obstacle = appel->obstacle;
+	appel->vue.moi = appel->moi;
+	appel->vue.adversaire = appel->adversaire;
+}
+
+// Garde la latence d'une réponse pour les statistiques
+void bot_compte(Bot *bot, double latence) {
+	if (bot->nb_coups == bot->capacite_latences) {
+		size_t capacite = (bot->capacite_latences == 0) ? 1024 : 2 * bot->capacite_latences;
+		double *latences = realloc(bot->latences, capacite * sizeof(double));
+		if (latences == NULL) {
+			printf("Erreur : mémoire insuffisante pour les statistiques du robot\n");
+			exit(1);
+		}
+		bot->latences = latences;
+		bot->capacite_latences = capacite;
+	}
+	bot->latences[bot->nb_coups++] = latence;
+}
+
+// Demande au robot la nouvelle direction de son serpent
+// Attend au plus vue->budget_us : sans réponse, le serpent va tout droit.
+// Un robot qui calcule encore la vue précédente ne reçoit pas celle-ci.
+Direction bot_direction(Bot *bot, const BotVue *vue, Direction direction) {
+	BotAppel *appel = bot->appel;
+	pthread_mutex_lock(&appel->verrou);
+	if (appel->occupe) {
+		// Compte le temps déjà passé sur la vue précédente
+		bot_compte(bot, temps_us() - appel->debut);
+		bot->nb_hors_delai++;
+		pthread_mutex_unlock(&appel->verrou);
+		return direction;
+	}
+	bot_copie_vue(appel, vue);
+	appel->prete = true;
+	appel->occupe = true;
+	appel->debut = temps_us();
+	pthread_cond_signal(&appel->demande);
+	// Heure limite de la réponse sur l'horloge monotone
+	struct timespec limite;
+	clock_gettime(CLOCK_MONOTONIC, &limite);
+	limite.tv_sec += vue->budget_us / 1000000;
+	limite.tv_nsec += (vue->budget_us % 1000000) * 1000;
+	if (limite.tv_nsec >= 1000000000) {
+		limite.tv_sec++;
+		limite.tv_nsec -= 1000000000;
+	}
+	int attente = 0;
+	while (appel->occupe && attente != ETIMEDOUT)
+		attente = pthread_cond_timedwait(&appel->reponse, &appel->verrou, &limite);
+	if (appel->occupe || appel->latence > vue->budget_us) {
+		bot_compte(bot, appel->occupe ? temps_us() - appel->debut : appel->latence);
+		bot->nb_hors_delai++;
+		pthread_mutex_unlock(&appel->verrou);
+		return direction;
+	}
+	bot_compte(bot, appel->latence);
+	BotTourne reponse = appel->resultat;
+	pthread_mutex_unlock(&appel->verrou);
+	switch (reponse) {
+		case BOT_GAUCHE: return turnLeft(direction);
+		case BOT_DROITE: return turnRight(direction);
+		default: return direction;
+	}
+}
+
+// Compare deux latences pour qsort
+int bot_compare_latences(const void *a, const void *b) {
+	double la = *(const double *)a;
+	double lb = *(const double *)b;
+	return (la > lb) - (la < lb);
+}
+
+// Latence du centile c (entre 0 et 100) des réponses du robot
+// Les latences doivent être triées par ordre croissant
+double bot_centile(const Bot *bot, double c) {
+	if (bot->nb_coups == 0)
+		return 0;
+	size_t rang = (size_t)ceil(c / 100 * bot->nb_coups);
+	return bot->latences[(rang == 0) ? 0 : rang - 1];
+}
+
+
 //////////////////////////////////////////////////////////////////////////
 // Partie test
 //////////////////////////////////////////////////////////////////////////
@@ -406,6 +1596,15 @@ void test_Pixel_String() {
 	assert(pix_equal(pix_pop_back(tab),p4));
 	assert(pix_len(tab) == 0);
 
+	// Enlève les pixels du début
+	pix_push_back(tab,size,p1);
+	pix_push_back(tab,size,p2);
+	assert(pix_equal(pix_pop(tab),p1));
+	assert(pix_len(tab) == 1);
+	assert(pix_equal(tab[0],p2));
+	assert(pix_equal(pix_pop(tab),p2));
+	assert(pix_len(tab) == 0);
+
 	printf("*** Le test des chaînes de Pixels est passé sans erreurs\n");
 }
 
@@ -422,10 +1621,13 @@ void test_obstacle() {
 	// du tableau car il faut compter la sentinelle
 	assert(len < size);
 
-	// On a besoin de curse pour définir LINES et COLS
+	// On a besoin de curse pour définir la taille de l'aire de jeux
 	startCurses();
+	aire_init();
 
-	// Initialise les obstacles
+	// Initialise les obstacles, avec un hasard fixé pour que le test soit
+	// le même à chaque lancement
+	srand(1);
 	obst_init(obst,size,len);
 
 	// Vérifie tous les obstacles
@@ -444,6 +1646,364 @@ void test_obstacle() {
 	printf("*** Le test des obstacles est passé sans erreurs\n");
 }
 
+// Test de l'empreinte de Zobrist incrémentale
+void test_zobrist() {
+	// Un seul obstacle dans le coin, loin des serpents
+	const size_t size_obst = 2;
+	Pixel obst[size_obst];
+	pix_clear(obst);
+	pix_push_back(obst, size_obst, pix_new(0,0));
+	// Deux serpents de longueur 5 qui peuvent grandir
+	const size_t size = 20;
+	Pixel snake1[size];
+	Pixel snake2[size];
+	const int growTimeMax = 2;
+	int growTime = growTimeMax;
+	Direction direction1 = versLaGauche;
+	Direction direction2 = versLaGauche;
+
+	// On a besoin de curse pour définir la taille de l'aire de jeux
+	startCurses();
+	aire_init();
+
+	snake_init(snake1, size, 5, 1);
+	snake_init(snake2, size, 5, 2);
+	GrilleObst grille;
+	grille_init(&grille, obst);
+	Zobrist zob;
+	zob_init(&zob, growTimeMax);
+	zob_reset(&zob, obst, snake1, snake2, direction1, direction2, growTime);
+	uint64_t hash_depart = zob.hash;
+	Delta delta;
+
+	// Le même état donne la même empreinte
+	assert(zob.hash == zob_calcule(&zob, obst, snake1, snake2, direction1, direction2, growTime));
+
+	// Les serpents tournent et grandissent : l'empreinte incrémentale
+	// doit toujours être égale à l'empreinte calculée entièrement
+	for (int i = 0; i < 8; i++) {
+		if (i == 3) {
+			// snake1 monte et snake2 descend pour ne pas se croiser
+			direction1 = turnRight(direction1);
+			direction2 = turnLeft(direction2);
+		}
+		GameStatus status = snake_move(snake1, snake2, size, &grille, direction1, direction2, growTime == 0, '2', &zob, &delta);
+		assert(status == GAME_RUNING);
+		growTime = (growTime == 0) ? growTimeMax : growTime - 1;
+		zob_set_grow(&zob, growTime);
+		assert(zob.hash == zob_calcule(&zob, obst, snake1, snake2, direction1, direction2, growTime));
+		assert(zob.hash != hash_depart);
+	}
+
+	grille_free(&grille);
+	zob_free(&zob);
+	stopCurses();
+
+	printf("*** Le test de l'empreinte de Zobrist est passé sans erreurs\n");
+}
+
+// Test de l'historique et du retour en arrière
+void test_historique() {
+	// Un tampon plein oublie les mouvements les plus anciens
+	Historique histo;
+	histo_init(&histo, 3, 0);
+	Delta delta;
+	for (unsigned char g = 0; g < 5; g++) {
+		delta.growTime = g;
+		delta.nb_obst = 0;
+		histo_push(&histo, &delta);
+	}
+	assert(histo.nb == 3);
+	assert(histo_pop(&histo, &delta) && delta.growTime == 4);
+	assert(histo_pop(&histo, &delta) && delta.growTime == 3);
+	assert(histo_pop(&histo, &delta) && delta.growTime == 2);
+	assert(!histo_pop(&histo, &delta));
+	histo_free(&histo);
+
+	// Pas d'obstacle
+	Pixel obst[1];
+	pix_clear(obst);
+	const size_t size = 20;
+	Pixel snake1[size];
+	Pixel snake2[size];
+	const int growTimeMax = 2;
+	int growTime = growTimeMax;
+	Direction direction1 = versLaGauche;
+	Direction direction2 = versLaGauche;
+	const int nb_mouvements = 8;
+	uint64_t hash[nb_mouvements + 1];
+	size_t len1[nb_mouvements + 1];
+
+	// On a besoin de curse pour définir la taille de l'aire de jeux
+	startCurses();
+	aire_init();
+
+	snake_init(snake1, size, 5, 1);
+	snake_init(snake2, size, 5, 2);
+	GrilleObst grille;
+	grille_init(&grille, obst);
+	Zobrist zob;
+	zob_init(&zob, growTimeMax);
+	zob_reset(&zob, obst, snake1, snake2, direction1, direction2, growTime);
+	histo_init(&histo, nb_mouvements, 0);
+	Pixel snake1_depart[size];
+	for (size_t i = 0; i < size; i++)
+		snake1_depart[i] = snake1[i];
+
+	// Les serpents avancent, tournent et grandissent
+	for (int i = 0; i < nb_mouvements; i++) {
+		hash[i] = zob.hash;
+		len1[i] = pix_len(snake1);
+		if (i == 3) {
+			direction1 = turnRight(direction1);
+			direction2 = turnLeft(direction2);
+		}
+		assert(snake_move(snake1, snake2, size, &grille, direction1, direction2, growTime == 0, '2', &zob, &delta) == GAME_RUNING);
+		growTime = (growTime == 0) ? growTimeMax : growTime - 1;
+		zob_set_grow(&zob, growTime);
+		histo_push(&histo, &delta);
+	}
+
+	// Chaque retour d'un mouvement redonne exactement l'état d'avant
+	for (int i = nb_mouvements - 1; i >= 0; i--) {
+		assert(partie_rewind(&histo, snake1, snake2, size, obst, &grille, 1, &zob) == 1);
+		assert(zob.hash == hash[i]);
+		assert(pix_len(snake1) == len1[i]);
+		assert(zob.hash == zob_calcule(&zob, obst, snake1, snake2, zob.dir[0], zob.dir[1], zob.growTime));
+	}
+	// Plus rien à annuler
+	assert(partie_rewind(&histo, snake1, snake2, size, obst, &grille, 1, &zob) == 0);
+	for (size_t i = 0; ! is_pix_end(snake1_depart[i]); i++)
+		assert(pix_equal(snake1[i], snake1_depart[i]));
+
+	histo_free(&histo);
+	grille_free(&grille);
+	zob_free(&zob);
+	stopCurses();
+
+	printf("*** Le test de l'historique est passé sans erreurs\n");
+}
+
+// Test du cycle hamiltonien et du solveur
+void test_cycle() {
+	// Quelques obstacles loin du départ des serpents
+	const size_t size_obst = 5;
+	Pixel obst[size_obst];
+	const size_t size = 30;
+	Pixel snake1[size];
+	Pixel snake2[size];
+	const int growTimeMax = 2;
+	int growTime = growTimeMax;
+	Direction direction = versLaGauche;
+
+	// On a besoin de curse pour définir la taille de l'aire de jeux
+	startCurses();
+	aire_init();
+
+	pix_clear(obst);
+	pix_push_back(obst, size_obst, pix_new(1,1));
+	pix_push_back(obst, size_obst, pix_new(aire_cols/4,aire_lines/4));
+	pix_push_back(obst, size_obst, pix_new(aire_cols-3,aire_lines-2));
+	snake_init(snake1, size, 5, 1);
+	pix_clear(snake2);
+	GrilleObst grille;
+	grille_init(&grille, obst);
+	Zobrist zob;
+	zob_init(&zob, growTimeMax);
+	zob_reset(&zob, obst, snake1, snake2, direction, direction, growTime);
+	Cycle cycle;
+	cycle_init(&cycle);
+	cycle_calcule(&cycle, obst, snake1[0]);
+
+	// Le cycle passe par des cases voisines, sans obstacle, une seule fois
+	assert(cycle.len > 0 && cycle.len % 4 == 0);
+	for (size_t i = 0; i < cycle.len; i++) {
+		Pixel p = cycle.cases[i];
+		Pixel q = cycle.cases[(i+1) % cycle.len];
+		assert(is_pix_in_game(p));
+		assert(abs(p.x-q.x) + abs(p.y-q.y) == 1);
+		assert(pix_find(obst, p) == NOT_FOUND);
+		assert(cycle_rang(&cycle, p) == (int)i);
+	}
+
+	// Le cycle relu depuis un fichier de cache est identique
+	// Le test est sauté si aucun fichier temporaire ne peut être créé
+	const uint64_t hash_test = 0x7e57;
+	FILE *f = tmpfile();
+	if (f != NULL) {
+		Cycle relu;
+		cycle_init(&relu);
+		assert(cycle_ecrit(&cycle, hash_test, f));
+		rewind(f);
+		assert(cycle_lit(&relu, hash_test, f));
+		assert(relu.len == cycle.len);
+		for (size_t i = 0; i < cycle.len; i++)
+			assert(pix_equal(relu.cases[i], cycle.cases[i]));
+		// Une autre disposition d'obstacles n'utilise pas ce cache
+		rewind(f);
+		assert(!cycle_lit(&relu, hash_test + 1, f));
+		assert(relu.len == 0);
+		fclose(f);
+		cycle_free(&relu);
+	}
+
+	// Le solveur fait grandir snake1 jusqu'à sa taille adulte
+	GameStatus status = GAME_RUNING;
+	Delta delta;
+	while (status == GAME_RUNING) {
+		direction = solveur_direction(&cycle, snake1, &grille, direction, growTime, growTimeMax);
+		status = snake_move(snake1, snake2, size, &grille, direction, direction, growTime == 0, '1', &zob, &delta);
+		growTime = (growTime == 0) ? growTimeMax : growTime - 1;
+		zob_set_grow(&zob, growTime);
+	}
+	assert(status == LEN_MAX);
+
+	cycle_free(&cycle);
+	grille_free(&grille);
+	zob_free(&zob);
+	stopCurses();
+
+	printf("*** Le test du cycle hamiltonien est passé sans erreurs\n");
+}
+
+// Test des obstacles mobiles
+void test_obst_mobile() {
+	// Définit un nombre d'obstacle à produire
+	const size_t len = 40;
+	const size_t size = len + 1;
+	Pixel obst[size];
+	Pixel obst_depart[size];
+	const size_t size_snake = 10;
+	Pixel snake1[size_snake];
+	Pixel snake2[size_snake];
+	// Nombre d'obstacles déplacés à chaque mouvement
+	const size_t nb = 10;
+	const int nb_mouvements = 20;
+	MouvObst journal[nb];
+	Delta delta;
+
+	// On a besoin de curse pour définir la taille de l'aire de jeux
+	startCurses();
+	aire_init();
+
+	// Obstacles tous différents sur les lignes du haut, loin du serpent
+	// Le hasard est fixé pour que le test soit le même à chaque lancement
+	srand(1);
+	pix_clear(obst);
+	for (size_t i = 0; i < len; i++)
+		pix_push_back(obst, size, pix_new(1 + 2*(i%20), 1 + 2*(i/20)));
+	for (size_t i = 0; i < size; i++)
+		obst_depart[i] = obst[i];
+	snake_init(snake1, size_snake, 5, 1);
+	pix_clear(snake2);
+	GrilleObst grille;
+	grille_init(&grille, obst);
+	Zobrist zob;
+	zob_init(&zob, 0);
+	zob_reset(&zob, obst, snake1, snake2, 0, 0, 0);
+	uint64_t hash_depart = zob.hash;
+	Historique histo;
+	histo_init(&histo, nb_mouvements, nb_mouvements * nb);
+
+	for (int m = 0; m < nb_mouvements; m++) {
+		// Un mouvement sans serpent qui bouge, seulement des obstacles
+		delta.tete[0] = delta.tete[1] = pix_end();
+		delta.queue[0] = delta.queue[1] = pix_end();
+		delta.dir[0] = delta.dir[1] = 0;
+		delta.growTime = 0;
+		delta.nb_obst = obst_bouge(obst, len, &grille, snake1, snake2, nb, &zob, journal);
+		for (size_t k = 0; k < delta.nb_obst; k++)
+			histo_push_obst(&histo, &journal[k]);
+		histo_push(&histo, &delta);
+
+		// L'index et l'empreinte suivent les obstacles déplacés
+		size_t nb_occupe = 0;
+		for (size_t c = 0; c < (size_t)grille.cols * grille.lines; c++)
+			nb_occupe += grille.occupe[c];
+		assert(nb_occupe == len);
+		for (size_t i = 0; i < len; i++) {
+			assert(is_pix_in_game(obst[i]));
+			assert(grille_contient(&grille, obst[i]));
+		}
+		// Un obstacle déplacé ne va jamais sur le serpent
+		for (size_t k = 0; k < delta.nb_obst; k++)
+			assert(pix_find(snake1, obst[journal[k].indice]) == NOT_FOUND);
+		assert(zob.hash == zob_calcule(&zob, obst, snake1, snake2, 0, 0, 0));
+	}
+
+	// Le retour en arrière remet chaque obstacle à sa place
+	assert(partie_rewind(&histo, snake1, snake2, size_snake, obst, &grille, nb_mouvements, &zob) == nb_mouvements);
+	for (size_t i = 0; i < len; i++)
+		assert(pix_equal(obst[i], obst_depart[i]));
+	assert(zob.hash == hash_depart);
+
+	histo_free(&histo);
+	grille_free(&grille);
+	zob_free(&zob);
+	stopCurses();
+
+	printf("*** Le test des obstacles mobiles est passé sans erreurs\n");
+}
+
+// Robot de test qui tourne toujours à gauche
+BotTourne test_bot_gauche(const BotVue *vue) {
+	(void)vue;
+	return BOT_GAUCHE;
+}
+
+// Robot de test qui répond après deux fois son temps de réponse maximum
+BotTourne test_bot_lent(const BotVue *vue) {
+	long attente_us = 2 * vue->budget_us;
+	struct timespec attente = {attente_us / 1000000, (attente_us % 1000000) * 1000};
+	nanosleep(&attente, NULL);
+	return BOT_GAUCHE;
+}
+
+// Test des robots et de leur temps de réponse maximum
+void test_bot() {
+	// Les directions de l'interface sont celles du jeux
+	assert((int)BOT_HAUT == (int)versLeHaut);
+	assert((int)BOT_BAS == (int)versLeBas);
+	assert((int)BOT_VERS_GAUCHE == (int)versLaGauche);
+	assert((int)BOT_VERS_DROITE == (int)versLaDroite);
+
+	// Une vue sans obstacles ni serpents suffit aux robots de test
+	BotVue vue;
+	memset(&vue, 0, sizeof(vue));
+	vue.budget_us = 1000;
+
+	// Un robot rapide est écouté
+	Bot gauche;
+	bot_init(&gauche, "gauche", test_bot_gauche);
+	assert(bot_direction(&gauche, &vue, versLeHaut) == versLaGauche);
+	assert(gauche.nb_coups == 1);
+	assert(gauche.nb_hors_delai == 0);
+
+	// Un robot trop lent va tout droit et son retard est compté
+	Bot lent;
+	bot_init(&lent, "lent", test_bot_lent);
+	assert(bot_direction(&lent, &vue, versLeHaut) == versLeHaut);
+	assert(lent.nb_coups == 1);
+	assert(lent.nb_hors_delai == 1);
+	assert(bot_centile(&lent, 50) >= vue.budget_us);
+	// Encore occupé par la vue précédente, il va tout droit sans attendre
+	assert(bot_direction(&lent, &vue, versLeHaut) == versLeHaut);
+	assert(lent.nb_coups == 2);
+	assert(lent.nb_hors_delai == 2);
+
+	// Un fichier absent n'est pas un robot
+	Bot absent;
+	char erreur[256];
+	assert(!bot_charge(&absent, "./robot_absent.so", erreur, sizeof(erreur)));
+	assert(strstr(erreur, "./robot_absent.so") != NULL);
+
+	// Le robot lent calcule encore : son fil le libère quand il a fini
+	bot_free(&gauche);
+	bot_free(&lent);
+
+	printf("*** Le test des robots est passé sans erreurs\n");
+}
+
 	// Paramétrage de la partie :
 	// Choisi une vitesse de jeux
 	// Choisi un temps de grossissement du serpent
@@ -455,6 +2015,8 @@ void test_obstacle() {
 	// On ajoute 1 pour stocker la sentinelle
 	// Longueur maximum que Snake doit atteindre pour être adulte
 	// Taille du tableau qui doit contenir la chaîne des Pixels
+	// Pourcentage des obstacles qui bougent, 0 si les obstacles sont fixes
+	// Nombre de mouvements entre deux déplacements des obstacles
 typedef struct{
 	int gameSpeed;
 	int growTimeMax;
@@ -462,9 +2024,13 @@ typedef struct{
 	size_t size_obst;
 	size_t len_max_snake;
 	size_t size_snake;
+	int obst_mobile_pourcent;
+	int obst_mobile_periode;
 } Partie;
 
-Partie param_partie(char difficulte){
+// obst_mobile_pourcent: pourcentage des obstacles qui bougent, 0 pour des obstacles fixes
+// obst_mobile_periode: nombre de mouvements entre deux déplacements des obstacles (1 ou plus)
+Partie param_partie(char difficulte, int obst_mobile_pourcent, int obst_mobile_periode){
 	Partie param_partie;
 	switch(difficulte)
 	{
@@ -473,27 +2039,237 @@ Partie param_partie(char difficulte){
 		case 'd': param_partie.gameSpeed = 70; param_partie.growTimeMax = 6; param_partie.len_obst = 120; param_partie.size_obst = param_partie.len_obst + 1; param_partie.len_max_snake = 110; param_partie.size_snake = param_partie.len_max_snake + 1; break;
 		default :  param_partie.gameSpeed = 100; param_partie.growTimeMax = 10; param_partie.len_obst = 30; param_partie.size_obst = param_partie.len_obst + 1; param_partie.len_max_snake = 100; param_partie.size_snake = param_partie.len_max_snake + 1; break;
 	}
+	assert(obst_mobile_pourcent >= 0 && obst_mobile_pourcent <= 100);
+	assert(obst_mobile_periode >= 1);
+	param_partie.obst_mobile_pourcent = obst_mobile_pourcent;
+	param_partie.obst_mobile_periode = obst_mobile_periode;
 
 	return param_partie;
 }
 
+// Lit au clavier un entier entre min et max
+// Redemande avec le message erreur tant que la saisie n'est pas valide
+int lire_entier(int min, int max, const char *erreur) {
+	int valeur;
+	while (scanf(" %d", &valeur) != 1 || valeur < min || valeur > max) {
+		// Abandonne la ligne saisie
+		if (scanf("%*[^\n]") == EOF) {
+			printf("\nErreur : fin de la saisie\n");
+			exit(1);
+		}
+		printf("%s", erreur);
+	}
+	scanf("%*[^\n]");
+	return valeur;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Partie tournoi entre robots, sans affichage
+//////////////////////////////////////////////////////////////////////////
+
+// Taille du jeux des parties du tournoi
+#define TOURNOI_COLS 80
+#define TOURNOI_LINES 24
+// Nombre de mouvements au-delà duquel une partie est nulle
+#define TOURNOI_MAX_MOUVEMENTS 10000
+// Nombre de parties par défaut entre deux robots
+#define TOURNOI_PARTIES 10
+
+// Joue une partie entre deux robots : bot1 dirige snake1 et bot2 dirige snake2
+// graine: initialise le hasard, donc la disposition des obstacles
+// Retourne 1 ou 2 pour le robot gagnant, 0 pour une partie nulle
+// trace: fichier de trace des empreintes (NULL pour ne pas tracer)
+int tournoi_partie(Bot *bot1, Bot *bot2, const Partie *parametre, unsigned int graine, FILE *trace) {
+	srand(graine);
+	Pixel obstacle[parametre->size_obst];
+	obst_init(obstacle, parametre->size_obst, parametre->len_obst);
+	GrilleObst grille;
+	grille_init(&grille, obstacle);
+	Pixel snake1[parametre->size_snake];
+	Pixel snake2[parametre->size_snake];
+	snake_init(snake1, parametre->size_snake, 5, 1);
+	snake_init(snake2, parametre->size_snake, 5, 2);
+	Direction direction1 = versLaGauche;
+	Direction direction2 = versLaGauche;
+	int growTime = parametre->growTimeMax;
+	Zobrist zob;
+	zob_init(&zob, parametre->growTimeMax);
+	zob_reset(&zob, obstacle, snake1, snake2, direction1, direction2, growTime);
+	zob_trace(trace, graine, 0, &zob);
+	// Vues données aux robots
+	BotCase moi[parametre->size_snake];
+	BotCase adversaire[parametre->size_snake];
+	BotVue vue;
+	long budget_us = bot_budget_us(parametre->gameSpeed);
+	Delta delta;
+	GameStatus status = GAME_RUNING;
+
+	for (int mouvement = 0; status == GAME_RUNING && mouvement < TOURNOI_MAX_MOUVEMENTS; mouvement++) {
+		// Les deux robots choisissent à partir du même état
+		bot_vue(&vue, &grille, snake1, snake2, moi, adversaire, direction1, direction2, growTime, mouvement, zob.hash, budget_us);
+		Direction nouvelle1 = bot_direction(bot1, &vue, direction1);
+		bot_vue(&vue, &grille, snake2, snake1, moi, adversaire, direction2, direction1, growTime, mouvement, zob.hash, budget_us);
+		direction2 = bot_direction(bot2, &vue, direction2);
+		direction1 = nouvelle1;
+		status = snake_move(snake1, snake2, parametre->size_snake, &grille, direction1, direction2, growTime == 0, '2', &zob, &delta);
+		growTime = (growTime == 0) ? parametre->growTimeMax : growTime - 1;
+		zob_set_grow(&zob, growTime);
+		zob_trace(trace, graine, mouvement + 1, &zob);
+	}
+	// Efface l'écran virtuel pour la partie suivante
+	clear();
+	grille_free(&grille);
+	zob_free(&zob);
+
+	// Partie trop longue, ou taille adulte atteinte : les deux serpents
+	// grandissent ensemble et sont vivants, l'ordre de mouvement des serpents
+	// ne doit pas les départager
+	if (status == GAME_RUNING || status == LEN_MAX)
+		return 0;
+	// snake1 bouge en premier : s'il n'a pas bougé, c'est lui qui a perdu
+	return is_pix_end(delta.tete[0]) ? 2 : 1;
+}
+
+// Joue un tournoi où chaque robot rencontre tous les autres
+// nb_parties parties par paire, en échangeant les serpents à chaque partie
+// Affiche le taux de victoire et les latences de chaque robot
+// Retourne le code de sortie du programme
+int tournoi(int nb_bots, char *chemins[], int nb_parties, char difficulte) {
+	if (nb_bots < 2) {
+		printf("Erreur : il faut au moins deux robots pour un tournoi\n");
+		return 1;
+	}
+	Bot bots[nb_bots];
+	int victoires[nb_bots];
+	int nulles[nb_bots];
+	int parties[nb_bots];
+	char erreur[256];
+	for (int i = 0; i < nb_bots; i++) {
+		if (!bot_charge(&bots[i], chemins[i], erreur, sizeof(erreur))) {
+			printf("Erreur : %s\n", erreur);
+			for (int j = 0; j < i; j++)
+				bot_free(&bots[j]);
+			return 1;
+		}
+		victoires[i] = nulles[i] = parties[i] = 0;
+	}
+	const Partie parametre = param_partie(difficulte, 0, 1);
+
+	// Trace des empreintes de chaque mouvement, si demandée
+	FILE *trace = zob_trace_ouvre();
+	startCursesSansEcran(TOURNOI_COLS, TOURNOI_LINES);
+	aire_init();
+	unsigned int graine = 0;
+	for (int a = 0; a < nb_bots; a++)
+		for (int b = a + 1; b < nb_bots; b++)
+			for (int p = 0; p < nb_parties; p++) {
+				// Une partie sur deux, a prend snake2 pour ne pas toujours bouger en premier
+				int un = (p % 2 == 0) ? a : b;
+				int deux = (p % 2 == 0) ? b : a;
+				int gagnant = tournoi_partie(&bots[un], &bots[deux], &parametre, graine, trace);
+				graine++;
+				parties[a]++;
+				parties[b]++;
+				if (gagnant == 1)
+					victoires[un]++;
+				else if (gagnant == 2)
+					victoires[deux]++;
+				else {
+					nulles[a]++;
+					nulles[b]++;
+				}
+			}
+	stopCurses();
+	if (trace != NULL)
+		fclose(trace);
+
+	printf("Tournoi de niveau %c, %d parties par paire de robots\n\n", difficulte, nb_parties);
+	printf("%-30s %7s %9s %7s %7s %9s %11s %9s %9s %9s %9s\n", "robot", "parties", "victoires", "nulles", "taux", "coups", "hors delai", "p50 (us)", "p90 (us)", "p99 (us)", "max (us)");
+	for (int i = 0; i < nb_bots; i++) {
+		Bot *bot = &bots[i];
+		qsort(bot->latences, bot->nb_coups, sizeof(double), bot_compare_latences);
+		printf("%-30s %7d %9d %7d %6.1f%% %9zu %11zu %9.1f %9.1f %9.1f %9.1f\n", bot->chemin, parties[i], victoires[i], nulles[i],
+			100.0 * victoires[i] / parties[i], bot->nb_coups, bot->nb_hors_delai,
+			bot_centile(bot, 50), bot_centile(bot, 90), bot_centile(bot, 99), bot_centile(bot, 100));
+		bot_free(bot);
+	}
+	return 0;
+}
+
+// Lit les arguments du tournoi : [-n parties] [-d f|m|d] robot.so robot.so ...
+// Retourne le code de sortie du programme
+int tournoi_main(int argc, char *argv[]) {
+	int nb_parties = TOURNOI_PARTIES;
+	char difficulte = 'f';
+	int i = 0;
+	while (i + 1 < argc && argv[i][0] == '-') {
+		if (strcmp(argv[i], "-n") == 0)
+			nb_parties = atoi(argv[i+1]);
+		else if (strcmp(argv[i], "-d") == 0)
+			difficulte = argv[i+1][0];
+		else
+			break;
+		i += 2;
+	}
+	if (nb_parties < 1 || (difficulte != 'f' && difficulte != 'm' && difficulte != 'd')) {
+		printf("Utilisation : snake tournoi [-n parties] [-d f|m|d] robot.so robot.so ...\n");
+		return 1;
+	}
+	return tournoi(argc - i, argv + i, nb_parties, difficulte);
+}
+
+
 //////////////////////////////////////////////////////////////////////////
 // Partie principale : l'initalisation, la boucle du jeux, et la fin
 //////////////////////////////////////////////////////////////////////////
 
-int main() {
+// Utilisation :
+//   snake                      partie au clavier
+//   snake robot1.so [robot2.so] les robots dirigent snake1 (et snake2)
+//   snake tournoi [-n parties] [-d f|m|d] robot.so robot.so ...
+int main(int argc, char *argv[]) {
+
+	// Tournoi entre robots, sans affichage ni tests
+	if (argc >= 2 && strcmp(argv[1], "tournoi") == 0)
+		return tournoi_main(argc - 2, argv + 2);
 
 	// Lance les tests du Test Driven Developpement
 	test_Pixel();
 	test_Pixel_String();
 	test_obstacle();
+	test_zobrist();
+	test_historique();
+	test_cycle();
+	test_obst_mobile();
+	test_bot();
+
+	// Robots qui remplacent le clavier pour diriger snake1 et snake2
+	Bot bots[2];
+	Bot *bot1 = NULL;
+	Bot *bot2 = NULL;
+	char erreur[256];
+	if (argc >= 2) {
+		if (!bot_charge(&bots[0], argv[1], erreur, sizeof(erreur))) {
+			printf("Erreur : %s\n", erreur);
+			return 1;
+		}
+		bot1 = &bots[0];
+	}
+	if (argc >= 3) {
+		if (!bot_charge(&bots[1], argv[2], erreur, sizeof(erreur))) {
+			printf("Erreur : %s\n", erreur);
+			bot_free(bot1);
+			return 1;
+		}
+		bot2 = &bots[1];
+	}
 
 	// Récupérer les informations pour créer la partie
 	char nbr_joueur = 0; // nombre de joueur (pouvant valoir 1 ou 2)
-	printf("\n\nCombien de joueur êtes vous ? (la réponse doit être 1 ou 2) : ");
+	printf("\n\nCombien de joueur êtes vous ? (la réponse doit être 1 ou 2, ou 0 pour laisser jouer le solveur) : ");
 	scanf(" %c%*[^\n]", &nbr_joueur);
-	while(nbr_joueur!='1' && nbr_joueur!='2') {
-		printf("Veuillez saisir 1 pour un seul joueur ou 2 pour deux joueurs : ");
+	while(nbr_joueur!='0' && nbr_joueur!='1' && nbr_joueur!='2') {
+		printf("Veuillez saisir 1 pour un seul joueur, 2 pour deux joueurs ou 0 pour le solveur : ");
 		scanf(" %c%*[^\n]", &nbr_joueur);
 		printf("%c\n", nbr_joueur);
 	}
@@ -504,20 +2280,36 @@ int main() {
 		printf("Saissir f pour facile\n     OU  m pour moyen\n     OU  d pour difficile : ");
 		scanf(" %c%*[^\n]", &difficulte_partie);
 	}
-	const Partie parametre = param_partie(difficulte_partie);
+	// Le cycle du solveur n'est valable que pour des obstacles fixes
+	int obst_mobile_pourcent = 0;
+	int obst_mobile_periode = 1;
+	if (nbr_joueur != '0') {
+		printf("\nQuel pourcentage des obstacles doit bouger ? (de 0 à 100, 0 pour des obstacles fixes) : ");
+		obst_mobile_pourcent = lire_entier(0, 100, "Saissir un nombre entre 0 et 100 : ");
+	}
+	if (obst_mobile_pourcent > 0) {
+		printf("\nTous les combien de mouvements les obstacles bougent ? (1 ou plus) : ");
+		obst_mobile_periode = lire_entier(1, 1000000, "Saissir un nombre de mouvements supérieur ou égal à 1 : ");
+	}
+	const Partie parametre = param_partie(difficulte_partie, obst_mobile_pourcent, obst_mobile_periode);
 	// Rappel des règles
 	char regles=0x00;
 	if(nbr_joueur == '1'){
-		printf("\n\nUne partie :\n\n\tpour %c joueur\n\tde niveau %c va se lancer.\n\nAvant de commencer la partie voici les règles :\n\n\tutilisez les flèches gauche et droite pour vous déplacer\n\n\ttoucher les bords, un obstacle ou votre serpent vous fait perdre\n\n\tune fois atteint une certaine taille vous avez gagné\n\nCliquez sur une touche puis ENTRER pour commencer :", nbr_joueur, difficulte_partie);
+		printf("\n\nUne partie :\n\n\tpour %c joueur\n\tde niveau %c va se lancer.\n\nAvant de commencer la partie voici les règles :\n\n\tutilisez les flèches gauche et droite pour vous déplacer\n\n\ttoucher les bords, un obstacle ou votre serpent vous fait perdre\n\n\tla touche r fait revenir le jeux %d secondes en arrière\n\n\tune fois atteint une certaine taille vous avez gagné\n\nCliquez sur une touche puis ENTRER pour commencer :", nbr_joueur, difficulte_partie, REWIND_SECONDES);
 		scanf(" %c*[^\n]", &regles);
 	}else if(nbr_joueur == '2') {
-		printf("\n\nUne partie : \n\n\tpour %c joueurs\n\t de niveau %c va se lancer.\n\nAvant de commencer la partie voici les règles :\n\n\tJoueur 1 utilise les flèches gauche et droite se déplacer\n\n\tJoueur 2 utilise les touches Q et S pour se déplacer\n\n\ttoucher les bords, un obstacle ou un serpent vous fait perdre\n\n\tune fois atteint une certaine taille vous avez gagné\n\nCliquez sur une touche puis ENTRER pour commencer : ", nbr_joueur, difficulte_partie);
+		printf("\n\nUne partie : \n\n\tpour %c joueurs\n\t de niveau %c va se lancer.\n\nAvant de commencer la partie voici les règles :\n\n\tJoueur 1 utilise les flèches gauche et droite se déplacer\n\n\tJoueur 2 utilise les touches Q et S pour se déplacer\n\n\ttoucher les bords, un obstacle ou un serpent vous fait perdre\n\n\tla touche r fait revenir le jeux %d secondes en arrière\n\n\tune fois atteint une certaine taille vous avez gagné\n\nCliquez sur une touche puis ENTRER pour commencer : ", nbr_joueur, difficulte_partie, REWIND_SECONDES);
+		scanf(" %c*[^\n]", &regles);
+	}else if(nbr_joueur == '0') {
+		printf("\n\nUne partie :\n\n\tjouée par le solveur\n\tde niveau %c va se lancer.\n\nLe serpent suit un cycle hamiltonien qui passe par toutes les cases libres\n\tles obstacles restent fixes pour que le cycle reste valable\n\nCliquez sur une touche puis ENTRER pour commencer : ", difficulte_partie);
 		scanf(" %c*[^\n]", &regles);
 	}
 	printf("\n\n\n");
 
 	// démarre le mode dessin curses sur le terminal
 	startCurses();
+	// L'aire de jeux garde cette taille jusqu'à la fin de la partie
+	aire_init();
 
 	// C'est le temps d'attente en ms dans l'entrée d'une touche avec getch()
 	timeout(parametre.gameSpeed);
@@ -530,10 +2322,23 @@ int main() {
 
 	// Définition du tableau qui contient la chaîne des obstacles
 	Pixel obstacle[parametre.size_obst];
+	// Initialise la fonction hasard (random)
+	srand (time(NULL));
 	// Initialisation des obstacles
 	obst_init(obstacle, parametre.size_obst, parametre.len_obst);
 	// Dessine les obstacles à l'écran
 	obst_draw(obstacle);
+	// Index des obstacles pour tester les collisions
+	GrilleObst grille;
+	grille_init(&grille, obstacle);
+	// Nombre d'obstacles qui bougent tous les obst_mobile_periode mouvements
+	size_t nb_obst_mobiles = parametre.len_obst * parametre.obst_mobile_pourcent / 100;
+	if (parametre.obst_mobile_pourcent > 0 && nb_obst_mobiles == 0)
+		nb_obst_mobiles = 1;
+	// Le nombre de déplacements d'un mouvement doit tenir dans Delta.nb_obst
+	assert(nb_obst_mobiles <= UINT_MAX);
+	// Déplacements d'obstacles du dernier mouvement (au moins une case)
+	MouvObst journal[nb_obst_mobiles + 1];
 
 	// Le serpent est definit par une chaîne de Pixels
 	// Pour pouvoir agrandir la chaîne, elle est stockée
@@ -557,27 +2362,80 @@ int main() {
 	// Affiche l'état de départ du sepent
 	snake_draw(snake1);
 
+	// Vue du jeux donnée aux robots et ses copies des serpents
+	BotVue vue;
+	BotCase bot_moi[parametre.size_snake];
+	BotCase bot_adversaire[parametre.size_snake];
+	const long budget_us = bot_budget_us(parametre.gameSpeed);
+
+	// Empreinte de l'état du jeux, mise à jour à chaque mouvement
+	Zobrist zob;
+	zob_init(&zob, parametre.growTimeMax);
+	zob_reset(&zob, obstacle, snake1, snake2, direction1, direction2, growTime);
+	// Trace des empreintes de chaque mouvement, si demandée
+	FILE *trace = zob_trace_ouvre();
+	zob_trace(trace, 0, 0, &zob);
+
+	// Historique des mouvements pour revenir en arrière avec la touche 'r'
+	Historique histo;
+	const size_t capacite_histo = HISTO_SECONDES * 1000 / parametre.gameSpeed;
+	histo_init(&histo, capacite_histo, (capacite_histo / parametre.obst_mobile_periode + 1) * nb_obst_mobiles);
+	// Ce qui a changé pendant le dernier mouvement
+	Delta delta;
+	// Nombre de mouvements annulés par un retour en arrière
+	int nb_annules;
+
+	// Cycle hamiltonien suivi par le solveur, en cache sur le disque
+	Cycle cycle = {0};
+	if (nbr_joueur == '0') {
+		cycle_init(&cycle);
+		cycle_prepare(&cycle, obstacle, snake1[0], zob_calcule_obst(&zob, obstacle));
+	}
+
 	// Caractère lu au clavier
 	int charRead;
 
 	// Etat du jeux après chaque mouvement
 	GameStatus gameStatus = GAME_RUNING;
 
-	// On réalise l'annimation tant que le jeux tourne pour 1 JOUEUR
-	while (gameStatus == GAME_RUNING && nbr_joueur == '1') {
+	// On réalise l'annimation tant que le jeux tourne pour 1 JOUEUR ou le solveur
+	while (gameStatus == GAME_RUNING && (nbr_joueur == '1' || nbr_joueur == '0')) {
+
+		// Le solveur ou le robot choisit la direction de Snake
+		if (nbr_joueur == '0')
+			direction1 = solveur_direction(&cycle,snake1,&grille,direction1,growTime,parametre.growTimeMax);
+		else if (bot1 != NULL) {
+			bot_vue(&vue,&grille,snake1,snake2,bot_moi,bot_adversaire,direction1,direction2,growTime,score,zob.hash,budget_us);
+			direction1 = bot_direction(bot1,&vue,direction1);
+		}
 
 		// Fait bouger le serpent et le fait grandir tout les growTimeMax mouvements
 		if (growTime == 0) {
 		// le serpent grandit
-			gameStatus = snake_move(snake1,snake2,parametre.size_snake,obstacle,direction1,direction2,true,nbr_joueur);
+			gameStatus = snake_move(snake1,snake2,parametre.size_snake,&grille,direction1,direction2,true,nbr_joueur,&zob,&delta);
 			growTime = parametre.growTimeMax;
 		} else {
 		// le serpent ne grandit pas
-			gameStatus = snake_move(snake1,snake2,parametre.size_snake,obstacle,direction1,direction2,false,nbr_joueur);
+			gameStatus = snake_move(snake1,snake2,parametre.size_snake,&grille,direction1,direction2,false,nbr_joueur,&zob,&delta);
 			growTime--;
 		}
+		// Met à jour l'empreinte de l'état pour ce mouvement
+		zob_set_grow(&zob, growTime);
+		// Déplace les obstacles mobiles et garde le mouvement pour pouvoir l'annuler
+		if (gameStatus == GAME_RUNING) {
+			if (nb_obst_mobiles > 0 && score % parametre.obst_mobile_periode == 0) {
+				delta.nb_obst = obst_bouge(obstacle,parametre.len_obst,&grille,snake1,snake2,nb_obst_mobiles,&zob,journal);
+				for (size_t k = 0; k < delta.nb_obst; k++)
+					histo_push_obst(&histo, &journal[k]);
+				// Un seul rafraîchissement pour tous les obstacles déplacés
+				refresh();
+			}
+			histo_push(&histo, &delta);
+		}
 		// Augmente le score à chaque mouvement
 		score++;
+		// Trace l'empreinte de l'état atteint par ce mouvement
+		zob_trace(trace, 0, score, &zob);
 
 		//  Lecture du clavier et attente de gameSpeed ms si aucune touche n'est enfoncée
 		// Ce temps est définit par la fonction timeout()
@@ -587,11 +2445,26 @@ int main() {
 		// Fin du jeux
 			case 'n': gameStatus = GAME_STOPPED;  break;
 			// Change la direction : demande à Sanke de tourner à droite
-			case KEY_RIGHT: direction1 = turnRight(direction1); break;
-			case 'q': direction2 = turnRight(direction2); break;
+			case KEY_RIGHT: if (bot1 == NULL) direction1 = turnRight(direction1); break;
+			case 'q': if (bot2 == NULL) direction2 = turnRight(direction2); break;
 			// Change la direction : demande à Sanke de tourner à gauche
-			case KEY_LEFT: direction1 = turnLeft(direction1); break;
-			case 's': direction2 = turnLeft(direction2); break;
+			case KEY_LEFT: if (bot1 == NULL) direction1 = turnLeft(direction1); break;
+			case 's': if (bot2 == NULL) direction2 = turnLeft(direction2); break;
+			// Revient en arrière de REWIND_SECONDES secondes puis met en pause
+			case 'r':
+				nb_annules = partie_rewind(&histo,snake1,snake2,parametre.size_snake,obstacle,&grille,REWIND_SECONDES * 1000 / parametre.gameSpeed,&zob);
+				if (nb_annules > 0) {
+					// Reprend les directions et le temps de grossissement d'avant
+					direction1 = zob.dir[0];
+					direction2 = zob.dir[1];
+					growTime = zob.growTime;
+					score -= nb_annules;
+					zob_trace(trace, 0, score, &zob);
+				}
+				timeout(-1);
+				getch();
+				timeout(parametre.gameSpeed);
+				break;
 			// Met en pause
 			case 'p': // Pause
 			// Le jeux est bloqué sur le getch() jusqu'à l'appui sur n'importe quelle touche
@@ -608,18 +2481,44 @@ int main() {
 
 	// On réalise l'annimation tant que le jeux tourne pour 2 JOUEURS
 	while (gameStatus == GAME_RUNING && nbr_joueur == '2') {
+		// Les robots choisissent la direction de leur serpent à partir du même état
+		Direction nouvelle1 = direction1;
+		if (bot1 != NULL) {
+			bot_vue(&vue,&grille,snake1,snake2,bot_moi,bot_adversaire,direction1,direction2,growTime,score,zob.hash,budget_us);
+			nouvelle1 = bot_direction(bot1,&vue,direction1);
+		}
+		if (bot2 != NULL) {
+			bot_vue(&vue,&grille,snake2,snake1,bot_moi,bot_adversaire,direction2,direction1,growTime,score,zob.hash,budget_us);
+			direction2 = bot_direction(bot2,&vue,direction2);
+		}
+		direction1 = nouvelle1;
 		// Fait bouger le serpent et le fait grandir tout les growTimeMax mouvements
 		if (growTime == 0) {
 			// le serpent grandit
-			gameStatus = snake_move(snake1,snake2,parametre.size_snake,obstacle,direction1,direction2,true,nbr_joueur);
+			gameStatus = snake_move(snake1,snake2,parametre.size_snake,&grille,direction1,direction2,true,nbr_joueur,&zob,&delta);
 			growTime = parametre.growTimeMax;
 		} else {
 		// le serpent ne grandit pas
-			gameStatus = snake_move(snake1,snake2,parametre.size_snake,obstacle,direction1,direction2,false,nbr_joueur);
+			gameStatus = snake_move(snake1,snake2,parametre.size_snake,&grille,direction1,direction2,false,nbr_joueur,&zob,&delta);
 			growTime--;
 		}
+		// Met à jour l'empreinte de l'état pour ce mouvement
+		zob_set_grow(&zob, growTime);
+		// Déplace les obstacles mobiles et garde le mouvement pour pouvoir l'annuler
+		if (gameStatus == GAME_RUNING) {
+			if (nb_obst_mobiles > 0 && score % parametre.obst_mobile_periode == 0) {
+				delta.nb_obst = obst_bouge(obstacle,parametre.len_obst,&grille,snake1,snake2,nb_obst_mobiles,&zob,journal);
+				for (size_t k = 0; k < delta.nb_obst; k++)
+					histo_push_obst(&histo, &journal[k]);
+				// Un seul rafraîchissement pour tous les obstacles déplacés
+				refresh();
+			}
+			histo_push(&histo, &delta);
+		}
 		// Augmente le score à chaque mouvement
 		score++;
+		// Trace l'empreinte de l'état atteint par ce mouvement
+		zob_trace(trace, 0, score, &zob);
 
 		//  Lecture du clavier et attente de gameSpeed ms si aucune touche n'est enfoncée
 		// Ce temps est définit par la fonction timeout()
@@ -629,11 +2528,26 @@ int main() {
 			// Fin du jeux
 			case 'n': gameStatus = GAME_STOPPED;  break;
 			// Change la direction : demande à Sanke de tourner à droite
-			case KEY_RIGHT: direction1 = turnRight(direction1); break;
-			case 'q': direction2 = turnLeft(direction2); break;
+			case KEY_RIGHT: if (bot1 == NULL) direction1 = turnRight(direction1); break;
+			case 'q': if (bot2 == NULL) direction2 = turnLeft(direction2); break;
 			// Change la direction : demande à Sanke de tourner à gauche
-			case KEY_LEFT: direction1 = turnLeft(direction1); break;
-			case 's': direction2 = turnRight(direction2); break;
+			case KEY_LEFT: if (bot1 == NULL) direction1 = turnLeft(direction1); break;
+			case 's': if (bot2 == NULL) direction2 = turnRight(direction2); break;
+			// Revient en arrière de REWIND_SECONDES secondes puis met en pause
+			case 'r':
+				nb_annules = partie_rewind(&histo,snake1,snake2,parametre.size_snake,obstacle,&grille,REWIND_SECONDES * 1000 / parametre.gameSpeed,&zob);
+				if (nb_annules > 0) {
+					// Reprend les directions et le temps de grossissement d'avant
+					direction1 = zob.dir[0];
+					direction2 = zob.dir[1];
+					growTime = zob.growTime;
+					score -= nb_annules;
+					zob_trace(trace, 0, score, &zob);
+				}
+				timeout(-1);
+				getch();
+				timeout(parametre.gameSpeed);
+				break;
       		// Met en pause
 			case 'p': // Pause
 			// Le jeux est bloqué sur le getch() jusqu'à l'appui sur n'importe quelle touche
@@ -664,5 +2578,18 @@ int main() {
 
 	printf("Snake a atteind la taille de %lu\n",pix_len(snake1));
 	printf("Votre score : %i\n",score);
+	printf("Empreinte de l'état final : %016" PRIx64 "\n",zob.hash);
+	if (trace != NULL)
+		fclose(trace);
+	zob_free(&zob);
+	histo_free(&histo);
+	cycle_free(&cycle);
+	grille_free(&grille);
+	// Temps de réponse des robots
+	for (int i = 0; i < 2; i++)
+		if ((i == 0 && bot1 != NULL) || (i == 1 && bot2 != NULL)) {
+			printf("Robot %s : %zu coups dont %zu hors délai\n", bots[i].chemin, bots[i].nb_coups, bots[i].nb_hors_delai);
+			bot_free(&bots[i]);
+		}
 	printf("Merci d'avoir joué ...\n");
 }
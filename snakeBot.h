@@ -0,0 +1,55 @@
+// Interface des robots (bots) qui dirigent un serpent à la place du clavier
+// Un robot est une bibliothèque partagée (.so) chargée avec dlopen.
+// Elle doit définir la fonction :
+//     BotTourne snake_bot_tourne(const BotVue *vue);
+// appelée à chaque mouvement, qui doit répondre en moins de vue->budget_us
+// microsecondes. Un robot trop lent continue tout droit.
+// La fonction est appelée dans un fil d'exécution (thread) à part : le jeux
+// n'attend pas un robot qui ne répond pas, et ne l'appelle plus tant qu'il
+// n'a pas fini de répondre à la vue précédente.
+#ifndef snakeBot_h
+#define snakeBot_h
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// Version de l'interface, incrémentée à chaque changement de BotVue
+#define SNAKE_BOT_VERSION 2
+
+// Nom du symbole que le robot doit exporter
+#define SNAKE_BOT_SYMBOLE "snake_bot_tourne"
+
+// Réponse du robot : le serpent ne peut que tourner ou aller tout droit
+typedef enum {BOT_TOUT_DROIT, BOT_GAUCHE, BOT_DROITE} BotTourne;
+
+// Directions, dans le même ordre que dans le jeux
+typedef enum {BOT_HAUT, BOT_BAS, BOT_VERS_GAUCHE, BOT_VERS_DROITE} BotDirection;
+
+// Une case du jeux
+typedef struct {
+	int x;
+	int y;
+} BotCase;
+
+// Vue en lecture seule du jeux donnée au robot à chaque mouvement
+typedef struct {
+	int version;                  // SNAKE_BOT_VERSION
+	int cols;                     // largeur du jeux
+	int lines;                    // hauteur du jeux
+	const bool *obstacle;         // cols * lines cases, obstacle[y * cols + x]
+	const BotCase *moi;           // le serpent du robot, la tête en 0
+	size_t len_moi;
+	const BotCase *adversaire;    // l'autre serpent, vide en partie à 1 serpent
+	size_t len_adversaire;
+	BotDirection direction;       // direction actuelle du serpent du robot
+	BotDirection direction_adversaire;
+	int growTime;                 // le serpent grandit au mouvement où growTime vaut 0
+	int mouvement;                // numéro du mouvement, à partir de 0
+	uint64_t empreinte;           // empreinte de Zobrist de l'état du jeux
+	long budget_us;               // temps de réponse maximum en microsecondes
+} BotVue;
+
+// Type de la fonction snake_bot_tourne
+typedef BotTourne (*SnakeBotFonction)(const BotVue *vue);
+
+#endif